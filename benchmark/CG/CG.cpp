@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+
+#include "CG/CG.h"
+#include "CG/CGDescent.h"
+
+#include "../Common.h"
+
+
+/// Previous gradient, current gradient and direction
+struct Vectors
+{
+    Vectors (int n) : fa(nlpp::Vec::Random(n)), fb(nlpp::Vec::Random(n)), dir(nlpp::Vec::Random(n))
+    {
+    }
+
+    nlpp::Vec fa, fb, dir;
+};
+
+
+/// Restart test and HZ factor with separate products and temporaries, as previously done in impl::CG::optimize
+static void BM_cgSeparateProducts (benchmark::State& state)
+{
+    Vectors v(state.range(0));
+
+    for(auto _ : state)
+    {
+        double ortho = v.fa.dot(v.fb) / v.fb.dot(v.fb);
+
+        nlpp::Vec y = v.fb - v.fa;
+
+        double yp = y.dot(v.dir);
+        double yy = y.dot(y);
+
+        double beta = (y - 2 * v.dir * (yy / yp)).dot(v.fb) / yp;
+
+        benchmark::DoNotOptimize(ortho);
+        benchmark::DoNotOptimize(beta);
+    }
+
+    state.SetBytesProcessed(state.iterations() * 3 * state.range(0) * sizeof(double));
+}
+
+/// The same, with every product in a single pass
+static void BM_cgProducts (benchmark::State& state)
+{
+    Vectors v(state.range(0));
+
+    for(auto _ : state)
+    {
+        auto p = nlpp::impl::cgProducts(v.fa, v.fb, v.dir);
+
+        double ortho = p.ab / p.bb;
+        double beta = nlpp::HZ{}(p);
+
+        benchmark::DoNotOptimize(ortho);
+        benchmark::DoNotOptimize(beta);
+    }
+
+    state.SetBytesProcessed(state.iterations() * 3 * state.range(0) * sizeof(double));
+}
+
+
+/// Whole optimization, reported per CG iteration. Includes the line search
+template <class CGType>
+static void BM_cg (benchmark::State& state)
+{
+    int iterations = 100;
+
+    nlpp::CG<CGType, nlpp::StrongWolfe<>, nlpp::stop::GradientOptimizer<>> opt;
+
+    opt.stop.maxIterations_ = iterations;
+    opt.stop.xTol = opt.stop.fTol = opt.stop.gTol = 0.0;
+
+    auto f = nlpp::wrap::functionGradient(RosenbrockGradient{});
+
+    nlpp::Vec x0 = nlpp::Vec::Constant(state.range(0), 1.2);
+
+    long allocs = 0;
+
+    for(auto _ : state)
+    {
+        long start = allocations;
+
+        nlpp::Vec x = opt(f, x0);
+
+        allocs += allocations - start;
+    }
+
+    state.counters["allocs/iter"] = benchmark::Counter(allocs / double(iterations), benchmark::Counter::kAvgIterations);
+    state.counters["time/iter"] = benchmark::Counter(iterations, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+
+/// Function/gradient calls and time to reach a gradient norm of 1e-6 from the same start point, or the value reached
+/// after 20000 iterations
+template <class Optimizer>
+static void BM_cgSolve (benchmark::State& state)
+{
+    Optimizer opt;
+
+    opt.stop.maxIterations_ = 20000;
+    opt.stop.xTol = opt.stop.fTol = 0.0;
+    opt.stop.gTol = 1e-6;
+
+    long calls = 0;
+
+    auto f = nlpp::wrap::functionGradient([&](const nlpp::Vec& x, nlpp::Vec& g){ ++calls; return RosenbrockGradient{}(x, g); });
+
+    nlpp::Vec x0 = nlpp::Vec::Constant(state.range(0), 1.2), x;
+
+    for(auto _ : state)
+        x = opt(f, x0);
+
+    nlpp::Vec gx(x.size());
+
+    state.counters["calls"] = benchmark::Counter(calls, benchmark::Counter::kAvgIterations);
+    state.counters["fx"] = RosenbrockGradient{}(x, gx);
+}
+
+
+BENCHMARK(BM_cgSeparateProducts)->RangeMultiplier(10)->Range(1000, 10000000);
+BENCHMARK(BM_cgProducts)->RangeMultiplier(10)->Range(1000, 10000000);
+
+BENCHMARK_TEMPLATE(BM_cg, nlpp::FR_PR)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_cg, nlpp::HZ)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_cgSolve, nlpp::CG<nlpp::FR_PR>)->RangeMultiplier(10)->Range(1000, 10000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_cgSolve, nlpp::CGDescent<>)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,15 @@
+#include <cstdlib>
+
+#include "Common.h"
+
+
+std::atomic<long> allocations{0};
+
+extern "C" void* __libc_malloc (std::size_t size);
+
+extern "C" void* malloc (std::size_t size)
+{
+    allocations++;
+
+    return __libc_malloc(size);
+}
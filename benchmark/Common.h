@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+
+#include "Helpers/Types.h"
+
+
+/// Number of heap allocations of the benchmark binary, including the ones of Eigen. Specific to glibc
+extern std::atomic<long> allocations;
+
+
+/// Rosenbrock function with its analytic gradient written on g, so no evaluation allocates
+struct RosenbrockGradient
+{
+    double operator () (const nlpp::Vec& x, nlpp::Vec& g) const
+    {
+        double r = 0.0;
+
+        g.setZero(x.size());
+
+        for(int i = 0; i < x.rows() - 1; ++i)
+        {
+            double a = x(i+1) - x(i) * x(i), b = x(i) - 1.0;
+
+            r += 100.0 * a * a + b * b;
+
+            g(i) += -400.0 * a * x(i) + 2.0 * b;
+            g(i+1) += 200.0 * a;
+        }
+
+        return r;
+    }
+};
@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+
+#include "Helpers/Wrappers.h"
+#include "TestFunctions/Rosenbrock.h"
+
+
+template <class Gradient>
+static void BM_rosenbrockGradient (benchmark::State& state, Gradient grad)
+{
+    nlpp::Vec x(state.range(0)), g(state.range(0));
+    std::for_each(x.data(), x.data() + x.size(), [](auto& xi){ xi = handy::rand(-10.0, 10.0); });
+
+    for(auto _ : state)
+    {
+        grad(x, g);
+        benchmark::DoNotOptimize(g.data());
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+
+BENCHMARK_CAPTURE(BM_rosenbrockGradient, finiteDifference, nlpp::fd::gradient(nlpp::Rosenbrock{}))
+    ->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond)->Complexity();
+
+/// Forward mode is also quadratic on N, so it is only compared on the smaller sizes
+BENCHMARK_CAPTURE(BM_rosenbrockGradient, forwardAD, nlpp::ad::gradient(nlpp::Rosenbrock{}))
+    ->RangeMultiplier(10)->Range(1000, 10000)->Unit(benchmark::kMillisecond)->Complexity();
+
+BENCHMARK_CAPTURE(BM_rosenbrockGradient, reverseAD, nlpp::ad::reverse(nlpp::Rosenbrock{}))
+    ->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond)->Complexity();
@@ -1,9 +1,29 @@
 #include <benchmark/benchmark.h>
 
 #include "Helpers/FiniteDifference.h"
+#include "Helpers/SparseFiniteDifference.h"
 #include "TestFunctions/Rosenbrock.h"
 
 
+/// Emulates an expensive black box function by repeating the evaluation of the Rosenbrock function
+struct ExpensiveRosenbrock
+{
+    template <class Derived>
+    double operator () (const Eigen::MatrixBase<Derived>& x)
+    {
+        double r = 0.0;
+
+        for(int i = 0; i < repeat; ++i)
+            r += func(x);
+
+        return r / repeat;
+    }
+
+    nlpp::Rosenbrock func;
+    int repeat = 1000;
+};
+
+
 template <class Function>
 static void BM_finiteGradient (benchmark::State& state, Function func)
 {
@@ -16,5 +36,50 @@ static void BM_finiteGradient (benchmark::State& state, Function func)
         auto g = grad(x);
 }
 
+template <class Function>
+static void BM_parallelFiniteGradient (benchmark::State& state, Function func)
+{
+    auto grad = nlpp::fd::gradient(func, nlpp::fd::Parallel(state.range(1)));
+
+    nlpp::Vec x(state.range(0));
+    std::for_each(x.data(), x.data() + x.size(), [](auto& xi){ xi = handy::rand(-10.0, 10.0); });
+
+    for(auto _ : state)
+        auto g = grad(x);
+}
+
+template <class Function>
+static void BM_finiteHessian (benchmark::State& state, Function func)
+{
+    auto hess = nlpp::fd::hessian(func);
+
+    nlpp::Vec x(state.range(0));
+    std::for_each(x.data(), x.data() + x.size(), [](auto& xi){ xi = handy::rand(0.5, 2.0); });
+
+    for(auto _ : state)
+        auto h = hess(x);
+}
+
+template <class Function>
+static void BM_sparseFiniteHessian (benchmark::State& state, Function func)
+{
+    nlpp::Vec x(state.range(0));
+    std::for_each(x.data(), x.data() + x.size(), [](auto& xi){ xi = handy::rand(0.5, 2.0); });
+
+    auto hess = nlpp::fd::sparseHessian(func, nlpp::fd::hessianPattern(func, x));
+
+    for(auto _ : state)
+        auto h = hess(x);
+}
+
+
+BENCHMARK_CAPTURE(BM_finiteGradient, rosenbrock, nlpp::Rosenbrock{})->Range(10, 100);
+
+BENCHMARK_CAPTURE(BM_finiteGradient, expensiveRosenbrock, ExpensiveRosenbrock{})->Arg(200)->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_parallelFiniteGradient, expensiveRosenbrock, ExpensiveRosenbrock{})
+    ->ArgsProduct({{200}, benchmark::CreateDenseRange(1, std::thread::hardware_concurrency(), 1)})->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_finiteHessian, rosenbrock, nlpp::Rosenbrock{})->RangeMultiplier(2)->Range(50, 400);
 
-BENCHMARK_CAPTURE(BM_finiteGradient, rosenbrock, nlpp::Rosenbrock{})->Range(10, 100);
\ No newline at end of file
+BENCHMARK_CAPTURE(BM_sparseFiniteHessian, rosenbrock, nlpp::Rosenbrock{})->RangeMultiplier(2)->Range(50, 400);
@@ -0,0 +1,231 @@
+#include <benchmark/benchmark.h>
+
+#include "Newton/Newton.h"
+#include "Newton/TruncatedNewton.h"
+
+#include "../Common.h"
+
+
+/// Symmetric indefinite hessian and a gradient
+struct System
+{
+    System (int n) : hess(nlpp::Mat::Random(n, n)), grad(nlpp::Vec::Random(n))
+    {
+        hess = hess + hess.transpose().eval();
+    }
+
+    nlpp::Mat hess;
+    nlpp::Vec grad;
+};
+
+
+/// Dense permutation products and explicit inverses, as previously done in fact::CholeskyFactorization
+static nlpp::Vec denseCholesky (const nlpp::Vec& grad, nlpp::Mat hess, double delta = 1e-3)
+{
+    int N = hess.rows();
+
+    double maxDiag = -1e20, maxOffDiag = -1e20;
+
+    for(int i = 0; i < N; ++i)
+    {
+        maxDiag = std::max(maxDiag, std::abs(hess(i, i)));
+
+        for(int j = 0; j < N; ++j) if(i != j)
+            maxOffDiag = std::max(maxOffDiag, std::abs(hess(i, j)));
+    }
+
+    double beta = std::max(nlpp::constants::eps, std::max(maxDiag, maxOffDiag / std::max(1.0, sqrt(N*N - 1.0))));
+
+    nlpp::Mat L = nlpp::Mat::Identity(N, N), C = nlpp::Mat::Identity(N, N), D = nlpp::Mat::Zero(N, N);
+    nlpp::Mat E = nlpp::Mat::Zero(N, N), Q = nlpp::Mat::Identity(N, N), O = nlpp::Mat::Identity(N, N);
+
+    for(int i = 0; i < N; ++i)
+        C(i, i) = hess(i, i);
+
+    for(int i = 0; i < N; ++i)
+    {
+        double val = -1e20;
+        int p = 0;
+
+        for(int j = i; j < N; ++j) if(std::abs(hess(j, j)) > val)
+            val = std::abs(hess(j, j)), p = j;
+
+        if(p != i)
+        {
+            nlpp::Mat P = nlpp::Mat::Identity(N, N);
+
+            P(i, i) = P(p, p) = 0.0;
+            P(i, p) = P(p, i) = 1.0;
+
+            hess = P * hess * P.transpose();
+
+            Q = P * Q;
+            O = O * P.transpose();
+        }
+
+        double phi = -1e20;
+
+        for(int j = 0; j < i; ++j)
+            L(i, j) = C(i, j) / D(j, j);
+
+        for(int j = i+1; j < N; ++j)
+        {
+            C(j, i) = hess(j, i);
+
+            for(int k = 0; k < i; ++k)
+                C(j, i) -= L(i, k) * C(j, k);
+
+            phi = std::max(phi, std::abs(C(j, i)));
+        }
+
+        if(i == N-1)
+            phi = 0.0;
+
+        D(i, i) = std::max(delta, std::max(std::abs(C(i, i)), pow(phi, 2) / beta));
+
+        E(i, i) = D(i, i) - C(i, i);
+
+        for(int j = i+1; j < N; ++j)
+            C(j, j) = C(j, j) - pow(C(j, i), 2) / D(i, i);
+    }
+
+    hess = Q.inverse() * (hess + E) * O.inverse();
+
+    return -hess.colPivHouseholderQr().solve(grad);
+}
+
+
+static void BM_denseCholesky (benchmark::State& state)
+{
+    System sys(state.range(0));
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(denseCholesky(sys.grad, sys.hess));
+}
+
+/// Factorization and direction, as called by Newton on each iteration
+static void BM_choleskyFactorization (benchmark::State& state)
+{
+    System sys(state.range(0));
+
+    nlpp::fact::CholeskyFactorization<> chol;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(chol(sys.grad, sys.hess));
+}
+
+
+/// Whole optimization with a finite difference hessian of the exact gradient, reporting the hessian evaluations
+template <class Refresh>
+static void BM_newtonRefresh (benchmark::State& state)
+{
+    nlpp::Newton<nlpp::fact::CholeskyFactorization<>, nlpp::StrongWolfe<>, nlpp::stop::GradientOptimizer<>,
+                 nlpp::out::GradientOptimizer<0>, Refresh> opt;
+
+    opt.stop = nlpp::stop::GradientOptimizer<>(1000, 0.0, 0.0, 1e-8);
+
+    auto f = nlpp::wrap::functionGradient(RosenbrockGradient{});
+    auto fdHess = nlpp::fd::hessian(f);
+
+    long calls = 0;
+
+    auto hess = [&](const nlpp::Vec& x) -> nlpp::Mat { ++calls; return fdHess(x); };
+
+    nlpp::Vec x0 = nlpp::Vec::Constant(state.range(0), 1.5);
+
+    for(auto _ : state)
+    {
+        opt.init();
+
+        benchmark::DoNotOptimize(opt.optimize(f, nlpp::wrap::hessian(hess), x0));
+    }
+
+    state.counters["hessians"] = benchmark::Counter(calls, benchmark::Counter::kAvgIterations);
+}
+
+
+using SpMat = Eigen::SparseMatrix<double>;
+
+/// Analytic tridiagonal hessian of the Rosenbrock function
+static SpMat rosenbrockHessian (const nlpp::Vec& x)
+{
+    int N = x.size();
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(3 * N);
+
+    nlpp::Vec diag = nlpp::Vec::Zero(N);
+
+    for(int i = 0; i < N - 1; ++i)
+    {
+        diag(i) += 1200.0 * x(i) * x(i) - 400.0 * x(i+1) + 2.0;
+        diag(i+1) += 200.0;
+
+        triplets.emplace_back(i, i+1, -400.0 * x(i));
+        triplets.emplace_back(i+1, i, -400.0 * x(i));
+    }
+
+    for(int i = 0; i < N; ++i)
+        triplets.emplace_back(i, i, diag(i));
+
+    SpMat hess(N, N);
+    hess.setFromTriplets(triplets.begin(), triplets.end());
+
+    return hess;
+}
+
+/// Whole optimization with the sparse factorization, or the dense one on the same hessian
+template <class Factorization, class Hessian>
+static void BM_newtonSparsity (benchmark::State& state)
+{
+    nlpp::Newton<Factorization, nlpp::StrongWolfe<>, nlpp::stop::GradientOptimizer<>, nlpp::out::GradientOptimizer<0>> opt;
+
+    opt.stop = nlpp::stop::GradientOptimizer<>(1000, 0.0, 0.0, 1e-8);
+
+    auto f = nlpp::wrap::functionGradient(RosenbrockGradient{});
+    auto hess = [](const nlpp::Vec& x) -> Hessian { return rosenbrockHessian(x); };
+
+    nlpp::Vec x0 = nlpp::Vec::Constant(state.range(0), 1.5);
+
+    for(auto _ : state)
+    {
+        opt.init();
+
+        benchmark::DoNotOptimize(opt.optimize(f, nlpp::wrap::hessian(hess), x0));
+    }
+}
+
+
+/// Hessian free, with a gradient difference on each product, reporting the gradient evaluations
+static void BM_truncatedNewton (benchmark::State& state)
+{
+    nlpp::TruncatedNewton<nlpp::StrongWolfe<>, nlpp::stop::GradientOptimizer<>, nlpp::out::GradientOptimizer<0>> opt;
+
+    opt.stop = nlpp::stop::GradientOptimizer<>(1000, 0.0, 0.0, 1e-8);
+
+    long calls = 0;
+
+    auto f = nlpp::wrap::functionGradient([&](const nlpp::Vec& x, nlpp::Vec& g) { ++calls; return RosenbrockGradient{}(x, g); });
+
+    nlpp::Vec x0 = nlpp::Vec::Constant(state.range(0), 1.5);
+
+    for(auto _ : state)
+    {
+        opt.init();
+
+        benchmark::DoNotOptimize(opt.optimize(f, x0));
+    }
+
+    state.counters["gradients"] = benchmark::Counter(calls, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_denseCholesky)->RangeMultiplier(2)->Range(25, 200)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_choleskyFactorization)->RangeMultiplier(2)->Range(25, 800)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_newtonRefresh, nlpp::newton::Always)->Arg(100)->Arg(500)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_newtonRefresh, nlpp::newton::Shamanskii<>)->Arg(100)->Arg(500)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_newtonSparsity, nlpp::fact::CholeskyIdentity<>, nlpp::Mat)->RangeMultiplier(10)->Range(100, 1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_newtonSparsity, nlpp::fact::SparseCholeskyIdentity<>, SpMat)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_truncatedNewton)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include "QuasiNewton/BFGS/BFGS.h"
+
+
+/// Symmetric positive definite inverse hessian and a pair with positive curvature
+struct Update
+{
+    Update (int n) : hess(nlpp::Mat::Identity(n, n)), s(nlpp::Vec::Random(n)), y(s + 0.1 * nlpp::Vec::Random(n)), hy(n)
+    {
+    }
+
+    nlpp::Mat hess;
+    nlpp::Vec s, y, hy;
+};
+
+
+/// Product form, as previously done in impl::BFGS::optimize
+static void BM_bfgsProductUpdate (benchmark::State& state)
+{
+    int n = state.range(0);
+
+    Update u(n);
+
+    nlpp::Mat In = nlpp::Mat::Identity(n, n);
+
+    for(auto _ : state)
+    {
+        double rho = 1.0 / u.y.dot(u.s);
+
+        u.hess = (In - rho * u.s * u.y.transpose()) * u.hess * (In - rho * u.y * u.s.transpose()) + rho * u.s * u.s.transpose();
+
+        benchmark::DoNotOptimize(u.hess.data());
+    }
+}
+
+/// Expanded rank two update, in place on the lower triangle
+static void BM_bfgsUpdate (benchmark::State& state)
+{
+    int n = state.range(0);
+
+    Update u(n);
+
+    for(auto _ : state)
+    {
+        nlpp::bfgs::Inverse<>::update(u.hess, u.s, u.y, u.hy);
+
+        benchmark::DoNotOptimize(u.hess.data());
+    }
+}
+
+/// Update followed by a direction, for each representation of the BFGS matrix
+template <class Approximation>
+static void BM_bfgsApproximation (benchmark::State& state)
+{
+    int n = state.range(0);
+
+    Update u(n);
+
+    Approximation approximation;
+
+    approximation.init(u.hess);
+
+    nlpp::Vec g = nlpp::Vec::Random(n), dir(n);
+
+    for(auto _ : state)
+    {
+        approximation.update(u.s, u.y);
+        approximation.direction(g, dir);
+
+        benchmark::DoNotOptimize(dir.data());
+    }
+}
+
+
+BENCHMARK(BM_bfgsProductUpdate)->Arg(100)->Arg(250)->Arg(500)->Arg(1000)->Arg(2000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_bfgsUpdate)->Arg(100)->Arg(250)->Arg(500)->Arg(1000)->Arg(2000)->Unit(benchmark::kMillisecond);
+
+
+BENCHMARK_TEMPLATE(BM_bfgsApproximation, nlpp::bfgs::Inverse<>)->Arg(1000)->Arg(2000)->Arg(5000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_bfgsApproximation, nlpp::bfgs::Cholesky<>)->Arg(1000)->Arg(2000)->Arg(5000)->Unit(benchmark::kMillisecond);
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include <benchmark/benchmark.h>
+
+#include "QuasiNewton/LBFGS/LBFGS.h"
+#include "TestFunctions/Rosenbrock.h"
+
+#include "../../Common.h"
+
+
+/// Rosenbrock function and analytic gradient as separate functors, counting the calls of each
+struct Counter
+{
+    long function = 0;
+    long gradient = 0;
+};
+
+struct CountedFunction
+{
+    double operator () (const nlpp::Vec& x) const
+    {
+        counter->function++;
+
+        return nlpp::Rosenbrock{}(x);
+    }
+
+    Counter* counter;
+};
+
+struct CountedGradient
+{
+    void operator () (const nlpp::Vec& x, nlpp::Vec& g) const
+    {
+        counter->gradient++;
+
+        RosenbrockGradient{}(x, g);
+    }
+
+    Counter* counter;
+};
+
+
+/// Scalar initial hessian, so only the history is measured
+struct UnitHessian
+{
+    template <class Function, class V>
+    double operator () (Function, const V&) const
+    {
+        return 1.0;
+    }
+};
+
+
+template <class History>
+History makeHistory (benchmark::State&)
+{
+    return History();
+}
+
+/// The compact representation takes the number of threads as the second argument
+template <>
+nlpp::lbfgs::Compact<> makeHistory<nlpp::lbfgs::Compact<>> (benchmark::State& state)
+{
+    return nlpp::lbfgs::Compact<>(state.range(1));
+}
+
+
+/// A single update followed by a two loop recursion, with a full history of m = 10 pairs
+template <class History>
+static void BM_lbfgsHistory (benchmark::State& state)
+{
+    int n = state.range(0), m = 10;
+
+    History history = makeHistory<History>(state);
+
+    history.init(n, m);
+
+    nlpp::Vec s = nlpp::Vec::Random(n), y = s + 0.1 * nlpp::Vec::Random(n), g = nlpp::Vec::Random(n), dir(n);
+
+    for(int i = 0; i < m; ++i)
+        history.update(s, y);
+
+    long start = allocations;
+
+    for(auto _ : state)
+    {
+        history.update(s, y);
+        history.direction(g, 1.0, dir);
+
+        benchmark::DoNotOptimize(dir.data());
+    }
+
+    state.counters["allocs"] = benchmark::Counter(allocations - start, benchmark::Counter::kAvgIterations);
+}
+
+/// Hessian vector products with the compact representation, as done by the CG iterations of a trust region step
+static void BM_lbfgsCompactProduct (benchmark::State& state)
+{
+    int n = state.range(0), m = 10;
+
+    nlpp::lbfgs::Compact<> history(state.range(1));
+
+    history.init(n, m);
+
+    nlpp::Vec s = nlpp::Vec::Random(n), y = s + 0.1 * nlpp::Vec::Random(n), v = nlpp::Vec::Random(n), out(n);
+
+    for(int i = 0; i < m; ++i)
+        history.update(s + 0.01 * i * v, y);
+
+    long start = allocations;
+
+    for(auto _ : state)
+    {
+        history.product(v, 1.0, out);
+
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["allocs"] = benchmark::Counter(allocations - start, benchmark::Counter::kAvgIterations);
+}
+
+/// Whole optimization, reported per L-BFGS iteration. Includes the allocations of the line search
+template <class History>
+static void BM_lbfgs (benchmark::State& state)
+{
+    int iterations = 100;
+
+    nlpp::LBFGS<UnitHessian, nlpp::StrongWolfe<>, nlpp::stop::GradientOptimizer<>, nlpp::out::GradientOptimizer<0>, History> opt;
+
+    opt.stop.maxIterations_ = iterations;
+    opt.stop.xTol = opt.stop.fTol = opt.stop.gTol = 0.0;
+
+    auto f = nlpp::wrap::functionGradient(RosenbrockGradient{});
+
+    nlpp::Vec x0 = nlpp::Vec::Constant(state.range(0), 1.2);
+
+    long allocs = 0;
+
+    for(auto _ : state)
+    {
+        long start = allocations;
+
+        nlpp::Vec x = opt(f, x0);
+
+        allocs += allocations - start;
+    }
+
+    state.counters["allocs/iter"] = benchmark::Counter(allocs / double(iterations), benchmark::Counter::kAvgIterations);
+    state.counters["time/iter"] = benchmark::Counter(iterations, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+
+/// Function and gradient calls of a whole optimization, as in examples/QuasiNewton/LBFGS
+template <class InitialHessian>
+static void BM_lbfgsEvaluations (benchmark::State& state)
+{
+    nlpp::LBFGS<InitialHessian, nlpp::StrongWolfe<>, nlpp::stop::GradientOptimizer<0>> opt;
+
+    opt.stop.maxIterations_ = 1e4;
+    opt.stop.xTol = opt.stop.fTol = opt.stop.gTol = 1e-4;
+
+    Counter counter;
+
+    auto f = nlpp::wrap::functionGradient(CountedFunction{&counter}, CountedGradient{&counter});
+
+    nlpp::Vec x0 = nlpp::Vec::Constant(state.range(0), 1.2);
+
+    nlpp::Vec x;
+
+    for(auto _ : state)
+        x = opt(f, x0);
+
+    state.counters["fx"] = nlpp::Rosenbrock{}(x);
+    state.counters["f"] = benchmark::Counter(counter.function, benchmark::Counter::kAvgIterations);
+    state.counters["g"] = benchmark::Counter(counter.gradient, benchmark::Counter::kAvgIterations);
+}
+
+/// Convergence of a whole optimization for a given storage of the pairs. The minimizer is x = 1
+template <class History>
+static void BM_lbfgsPrecision (benchmark::State& state)
+{
+    nlpp::LBFGS<nlpp::LBFGS_Scaling<>, nlpp::StrongWolfe<>, nlpp::stop::GradientOptimizer<0>, nlpp::out::GradientOptimizer<0>, History> opt;
+
+    opt.stop.maxIterations_ = 1e4;
+    opt.stop.xTol = opt.stop.fTol = 0.0;
+    opt.stop.gTol = 1e-6;
+
+    Counter counter;
+
+    auto f = nlpp::wrap::functionGradient(CountedFunction{&counter}, CountedGradient{&counter});
+
+    nlpp::Vec x0 = nlpp::Vec::Constant(state.range(0), 1.2);
+
+    nlpp::Vec x;
+
+    for(auto _ : state)
+        x = opt(f, x0);
+
+    state.counters["fx"] = nlpp::Rosenbrock{}(x);
+    state.counters["error"] = (x - nlpp::Vec::Ones(x.size())).norm();
+    state.counters["g"] = benchmark::Counter(counter.gradient, benchmark::Counter::kAvgIterations);
+}
+
+
+BENCHMARK_TEMPLATE(BM_lbfgsHistory, nlpp::lbfgs::Deque<>)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(BM_lbfgsHistory, nlpp::lbfgs::Ring<>)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(BM_lbfgsHistory, nlpp::lbfgs::Ring<double, float>)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(BM_lbfgsHistory, nlpp::lbfgs::Ring<double, Eigen::bfloat16>)->RangeMultiplier(10)->Range(1000, 1000000);
+/// Wall time, so the speedup of the threaded products is measured
+BENCHMARK_TEMPLATE(BM_lbfgsHistory, nlpp::lbfgs::Compact<>)->ArgsProduct({{1000, 10000, 100000, 1000000}, {1, 4}})->UseRealTime();
+BENCHMARK(BM_lbfgsCompactProduct)->ArgsProduct({{1000, 100000}, {1, 4}})->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_lbfgs, nlpp::lbfgs::Deque<>)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE(BM_lbfgs, nlpp::lbfgs::Ring<>)->RangeMultiplier(10)->Range(1000, 100000);
+
+BENCHMARK_TEMPLATE(BM_lbfgsEvaluations, nlpp::BFGS_Diagonal<>)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_lbfgsEvaluations, nlpp::BFGS_Constant<>)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_lbfgsEvaluations, nlpp::LBFGS_Scaling<>)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_lbfgsEvaluations, nlpp::LBFGS_DiagonalScaling<>)->RangeMultiplier(10)->Range(10, 1000);
+
+BENCHMARK_TEMPLATE(BM_lbfgsPrecision, nlpp::lbfgs::Ring<>)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK_TEMPLATE(BM_lbfgsPrecision, nlpp::lbfgs::Ring<double, float>)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK_TEMPLATE(BM_lbfgsPrecision, nlpp::lbfgs::Ring<double, Eigen::bfloat16>)->RangeMultiplier(10)->Range(10, 10000);
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+
+#include "TrustRegion/DogLeg/DogLeg.h"
+#include "TrustRegion/Steihaug/Steihaug.h"
+
+#include "../../Common.h"
+
+
+/// Analytic gradient, with the default hessian of each local minimizer: a dense one from N+1 gradient calls for the
+/// dog leg, and a gradient difference on each product for Steihaug
+template <class Optimizer>
+static void BM_trustRegion (benchmark::State& state)
+{
+    Optimizer opt;
+
+    opt.stop = nlpp::stop::GradientNorm<>(10000, 1e-8);
+
+    auto f = nlpp::wrap::functionGradient(RosenbrockGradient{});
+
+    nlpp::Vec x0 = nlpp::Vec::Constant(state.range(0), 2.0);
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(opt.optimize(f, x0));
+}
+
+
+using DogLeg = nlpp::DogLeg<nlpp::stop::GradientNorm<>, nlpp::out::GradientOptimizer<0>>;
+using Steihaug = nlpp::Steihaug<nlpp::stop::GradientNorm<>, nlpp::out::GradientOptimizer<0>>;
+
+BENCHMARK_TEMPLATE(BM_trustRegion, DogLeg)->RangeMultiplier(10)->Range(100, 1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_trustRegion, Steihaug)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,33 @@
+///[AutoDiff snippet]
+
+#include <iostream>
+#include "Helpers/AutoDiff.h"
+
+using namespace Eigen;
+using namespace nlpp;
+
+
+int main ()
+{
+    auto func = [](const auto& x)
+    {
+        using std::sin;
+
+        return x[0] * x[0] * x[0] + 2 * x[1] * x[1] + 5 * sin(x[0] * x[1]);
+    };
+
+    auto grad = ad::gradient(func);
+
+    VectorXd x(2), g(2);
+    x << 3.0, 2.0;
+
+
+    grad(x, g);
+
+    handy::print(g);
+
+
+    return 0;   
+}
+
+///[AutoDiff snippet]
@@ -27,16 +27,22 @@
 									using Params::v;
 
 
-/// Builds a functor, to avoid a lot of copy/paste
+/// Builds a functor, to avoid a lot of copy/paste. The factor is written in terms of the products @c p of the gradients
 #define BUILD_CG_STRUCT(Op, ...) \
 \
 struct __VA_ARGS__ \
 {\
-	template <class V>	\
-	impl::Scalar<V> operator () (const V& fa, const V& fb, const V& dir = V()) const \
+	template <typename Float>	\
+	Float operator () (const impl::CGProducts<Float>& p) const \
 	{\
 		Op; \
 	}\
+\
+	template <class V>	\
+	impl::Scalar<V> operator () (const V& fa, const V& fb, const V& dir) const \
+	{\
+		return operator()(impl::cgProducts(fa, fb, dir)); \
+	}\
 };
 
 
@@ -44,33 +50,81 @@ struct __VA_ARGS__ \
 namespace nlpp
 {
 
-/** @name
- *  @brief The choice of the factor
+namespace impl
+{
+
+/** @brief Every inner product needed by the CG factors and the restart test, with @c fa and @c fb the previous and
+ * 		   current gradients, @c d the previous direction and @f$y = fb - fa@f$
 */
-//@{
-BUILD_CG_STRUCT(return fb.dot(fb) / fa.dot(fa), FR);
+template <typename Float>
+struct CGProducts
+{
+	Float aa = 0.0;		///< @f$fa^\intercal fa@f$
+	Float ab = 0.0;		///< @f$fa^\intercal fb@f$
+	Float bb = 0.0;		///< @f$fb^\intercal fb@f$
+	Float bd = 0.0;		///< @f$fb^\intercal d@f$
+	Float dd = 0.0;		///< @f$d^\intercal d@f$
+	Float yb = 0.0;		///< @f$y^\intercal fb@f$
+	Float yd = 0.0;		///< @f$y^\intercal d@f$
+	Float yy = 0.0;		///< @f$y^\intercal y@f$
+};
+
+/** @brief All the products in a single pass over memory
+ * 
+ *  @details The vectors are split in blocks small enough to stay in the L1 cache, so each block is read from memory
+ * 			 once and the eight products are taken (vectorized) from the cache. The products with @c y are taken
+ * 			 directly, instead of expanded, to avoid cancellation when @c fa and @c fb are close.
+*/
+template <class V>
+CGProducts<Scalar<V>> cgProducts (const V& fa, const V& fb, const V& dir)
+{
+	constexpr int blockSize = 512;
 
-BUILD_CG_STRUCT(return fb.dot(fb - fa) / fa.dot(fa), PR);
+	CGProducts<Scalar<V>> p;
 
-BUILD_CG_STRUCT(return std::abs(PR::operator()(fa, fb)), PR_Abs : PR);
+	for(int i = 0; i < fa.size(); i += blockSize)
+	{
+		int n = std::min<int>(blockSize, fa.size() - i);
+
+		auto a = fa.segment(i, n);
+		auto b = fb.segment(i, n);
+		auto d = dir.segment(i, n);
+
+		p.aa += a.squaredNorm();
+		p.ab += a.dot(b);
+		p.bb += b.squaredNorm();
+		p.bd += b.dot(d);
+		p.dd += d.squaredNorm();
+		p.yb += (b - a).dot(b);
+		p.yd += (b - a).dot(d);
+		p.yy += (b - a).squaredNorm();
+	}
 
-BUILD_CG_STRUCT(return std::max(0.0, PR::operator()(fa, fb)), PR_Plus : PR);
+	return p;
+}
 
-BUILD_CG_STRUCT(return fb.dot(fb - fa) / dir.dot(fb - fa), HS);
+} // namespace impl
 
-BUILD_CG_STRUCT(return fb.dot(fb) / dir.dot(fb - fa), DY);
+/** @name
+ *  @brief The choice of the factor
+*/
+//@{
+BUILD_CG_STRUCT(return p.bb / p.aa, FR);
+
+BUILD_CG_STRUCT(return p.yb / p.aa, PR);
 
-BUILD_CG_STRUCT(Vec y = fb - fa;
+BUILD_CG_STRUCT(return std::abs(PR::operator()(p)), PR_Abs : PR);
 
-				auto yp = y.dot(dir);
-				auto yy = y.dot(y);
+BUILD_CG_STRUCT(return std::max(Float(0.0), PR::operator()(p)), PR_Plus : PR);
 
-				return (y - 2 * dir * (yy / yp)).dot(fb) / yp;,
+BUILD_CG_STRUCT(return p.yb / p.yd, HS);
 
-				HZ);
+BUILD_CG_STRUCT(return p.bb / p.yd, DY);
 
-BUILD_CG_STRUCT(auto fr = FR::operator()(fa, fb);
-				auto pr = PR::operator()(fa, fb);
+BUILD_CG_STRUCT(return (p.yb - 2 * p.bd * (p.yy / p.yd)) / p.yd, HZ);
+
+BUILD_CG_STRUCT(auto fr = FR::operator()(p);
+				auto pr = PR::operator()(p);
 
 				if(pr < -fr) return -fr;
 
@@ -127,41 +181,39 @@ struct CG : public params::CG<Params_, CGType>
 	using Params::Params;
 
 
+	/** @details Every buffer is allocated before the first iteration. Besides the line search, each iteration makes a
+	 * 			 single pass over the gradients and direction for all the products and another one for the new direction.
+	 * 			 The accepted point and the gradients are swapped instead of copied.
+	*/
 	template <class Function, class V>
 	V optimize (Function f, V x)
 	{
-		V fa, dir, fb(x.rows(), x.cols());
-
-		impl::Scalar<V> fxOld, fx;
+		V fa(x.rows(), x.cols()), fb(x.rows(), x.cols()), dir(x.rows(), x.cols()), xn(x.rows(), x.cols());
 
-		std::tie(fxOld, fa) = f(x);
+		impl::Scalar<V> fx = f(x, fa);
 
 		dir = -fa;
 
 		for(int iter = 0; iter < stop.maxIterations(); ++iter)
 		{
-			double alpha = lineSearch(f, x, dir);
-			
-			x = x + alpha * dir;
+			lineSearch(f, x, dir, fx, fb, xn);
 
-			fx = f(x, fb);
-			
+			x.swap(xn);
 
 			if(stop(*this, x, fx, fb))
 				break;
 
-			if((fa.dot(fb) / fb.dot(fb)) >= v)
+			auto p = impl::cgProducts(fa, fb, dir);
+
+			if(p.ab / p.bb >= v)
 				dir = -fb;
 
 			else
-				dir = -fb + cg(fa, fb, dir) * dir;
-
-
-			fxOld = fx;
+				dir = cg(p) * dir - fb;
 
-			fa = fb;
+			fa.swap(fb);
 
-			output(*this, x, fx, fb);
+			output(*this, x, fx, fa);
 		}
 
 		return x;
@@ -0,0 +1,412 @@
+/** @file
+ *  @brief CG_DESCENT, the conjugate gradient method of Hager and Zhang
+ *
+ *  @details The direction uses the @c HZ factor, bounded below by @f$\eta_k = -1 / (\|d_k\| \min(\eta, \|g_k\|))@f$,
+ * 			 which keeps the sufficient descent property without the orthogonality restart of CG. The line search
+ * 			 is the one of Hager and Zhang, built around the approximate Wolfe conditions:
+ *
+ * 			 @f[ (2\delta - 1) \phi'(0) \geq \phi'(a) \geq \sigma \phi'(0), \quad \phi(a) \leq \phi(0) + \epsilon_k @f]
+ *
+ * 			 which, unlike the Armijo condition, can still be checked accurately near the solution, where the
+ * 			 differences of function values are lost to rounding. The bracket is shrunk by a double secant step,
+ * 			 falling back to bisection when it does not shrink enough.
+ *
+ * 			 Most of the iterations take a single evaluation, at the step given by a quadratic fit along the new
+ * 			 direction, so the cost per iteration is close to the one of a single function/gradient call.
+*/
+
+#pragma once
+
+#include "CG.h"
+
+
+/// Macro aliases
+#define CPPOPT_USING_PARAMS_CG_DESCENT(...) CPPOPT_USING_PARAMS(__VA_ARGS__);		\
+											using Params::eta;						\
+											using Params::restartFactor;			\
+											using Params::approximateFactor;		\
+											using Params::decay;
+
+
+namespace nlpp
+{
+
+namespace hz
+{
+
+/** @brief The line search of Hager and Zhang
+ *
+ *  @details Called with the function/gradient value at @c x on @c fx and @c gx, it writes the accepted point on @c xn
+ * 			 and its values on @c fx and @c gn. The standard Wolfe conditions are used until @c approximate is set,
+ * 			 which is done by the optimizer when the function values stop changing.
+*/
+template <typename Float = types::Float>
+struct ApproximateWolfe
+{
+	/// A step with its function value and directional derivative
+	struct Point
+	{
+		Float a;
+		Float f;
+		Float g;
+	};
+
+	ApproximateWolfe (Float delta = 0.1, Float sigma = 0.9, Float epsilon = 1e-6, Float theta = 0.5, Float gamma = 0.66,
+					  Float rho = 5.0, int maxIterations = 50) : delta(delta), sigma(sigma), epsilon(epsilon), theta(theta),
+					  gamma(gamma), rho(rho), maxIterations(maxIterations)
+	{
+		assert(delta > 0.0 && delta < 0.5 && "delta must be in (0, 0.5)");
+		assert(sigma >= delta && sigma < 1.0 && "sigma must be in [delta, 1)");
+	}
+
+	void initialize ()
+	{
+		aPrev = 0.0;
+		approximate = false;
+	}
+
+
+	template <class Function, class V>
+	Float operator () (Function f, const V& x, const V& dir, Float& fx, const V& gx, V& xn, V& gn)
+	{
+		Phi<Function, V> phi{*this, f, x, dir, xn, gn, fx + epsilon * std::abs(fx), {0.0, fx, gx.dot(dir)}};
+
+		Point a = phi.zero, b, c;
+
+		bool done = phi(initialStep(phi, x, gx), c) || bracket(phi, a, b, c);
+
+		for(int iter = 0; !done && iter < maxIterations && b.a - a.a > constants::eps_<Float> * b.a; ++iter)
+		{
+			Float width = b.a - a.a;
+
+			done = secant2(phi, a, b);
+
+			if(!done && b.a - a.a > gamma * width)
+				done = update(phi, a, b, (a.a + b.a) / 2);
+		}
+
+		/// Without an acceptable step, take the lowest point evaluated, or stay at x if none of them is a decrease
+		if(!done && phi.best.a == 0.0)
+		{
+			xn = x;
+			gn = gx;
+			phi.last = phi.zero;
+		}
+
+		else if(!done && phi.last.a != phi.best.a)
+			phi(phi.best.a, c);
+
+		fx = phi.last.f;
+		aPrev = phi.last.a;
+
+		return aPrev;
+	}
+
+
+	/// @f$\phi(a) = f(x + a d)@f$, also checking the Wolfe conditions on each evaluation
+	template <class Function, class V>
+	struct Phi
+	{
+		bool operator () (Float a, Point& p)
+		{
+			xn = x + a * dir;
+
+			p = last = {a, f(xn, gn), gn.dot(dir)};
+
+			if(p.f < best.f)
+				best = p;
+
+			if(ls.approximate)
+				return (2 * ls.delta - 1) * zero.g >= p.g && p.g >= ls.sigma * zero.g && p.f <= bound;
+
+			return p.f <= zero.f + ls.delta * a * zero.g && p.g >= ls.sigma * zero.g;
+		}
+
+		Float function (Float a)
+		{
+			xn = x + a * dir;
+
+			return f.function(xn);
+		}
+
+		const ApproximateWolfe& ls;
+		Function& f;
+		const V& x;
+		const V& dir;
+		V& xn;
+		V& gn;
+		Float bound;		///< @f$\phi(0) + \epsilon_k@f$
+		Point zero;
+		Point last = {0.0, 0.0, 0.0};
+		Point best = zero;	///< The lowest point evaluated, starting at @c zero
+	};
+
+
+	/** @brief The step I0 at the first call, and I1 (QuadStep) or I2 after
+	 *
+	 *  @details I1 fits a quadratic on @f$\phi(0)@f$, @f$\phi'(0)@f$ and @f$\phi(\psi_1 a_{k-1})@f$, taking its
+	 * 			 minimizer if it is convex and @f$\phi(\psi_1 a_{k-1}) \leq \phi(0)@f$. Otherwise the previous step is
+	 * 			 expanded by @f$\psi_2@f$.
+	*/
+	template <class P, class V>
+	Float initialStep (P& phi, const V& x, const V& gx)
+	{
+		if(aPrev <= 0.0)
+		{
+			Float xNorm = x.template lpNorm<Eigen::Infinity>();
+
+			if(xNorm != 0.0)
+				return psi0 * xNorm / gx.template lpNorm<Eigen::Infinity>();
+
+			if(phi.zero.f != 0.0)
+				return psi0 * std::abs(phi.zero.f) / gx.squaredNorm();
+
+			return 1.0;
+		}
+
+		Float r = psi1 * aPrev, fr = phi.function(r);
+		Float q = (fr - phi.zero.f - phi.zero.g * r) / (r * r);
+
+		if(q > 0.0 && fr <= phi.zero.f)
+			return -phi.zero.g / (2 * q);
+
+		return psi2 * aPrev;
+	}
+
+
+	/// Expands the step @c c until the derivative is nonnegative or the function is above the bound (B1-B3)
+	template <class P>
+	bool bracket (P& phi, Point& a, Point& b, Point c)
+	{
+		for(int iter = 0; iter < maxIterations; ++iter)
+		{
+			if(c.g >= 0.0)
+			{
+				b = c;
+				return false;
+			}
+
+			if(c.f > phi.bound)
+			{
+				b = c;
+				return bisect(phi, a, b);
+			}
+
+			a = c;
+
+			if(phi(rho * c.a, c))
+				return true;
+		}
+
+		b = c;
+
+		return false;
+	}
+
+
+	/// Shrinks the bracket @c [a, b] with a trial step @c c inside of it (U0-U3)
+	template <class P>
+	bool update (P& phi, Point& a, Point& b, Float c)
+	{
+		/// Also rejects a nan from a degenerate secant
+		if(!(c > a.a && c < b.a))
+			return false;
+
+		Point p;
+
+		if(phi(c, p))
+			return true;
+
+		if(p.g >= 0.0)
+			b = p;
+
+		else if(p.f <= phi.bound)
+			a = p;
+
+		else
+		{
+			b = p;
+			return bisect(phi, a, b);
+		}
+
+		return false;
+	}
+
+	/// The bracket has a negative derivative and a function value above the bound on @c b (U3)
+	template <class P>
+	bool bisect (P& phi, Point& a, Point& b)
+	{
+		for(int iter = 0; iter < maxIterations; ++iter)
+		{
+			Point d;
+
+			if(phi((1 - theta) * a.a + theta * b.a, d))
+				return true;
+
+			if(d.g >= 0.0)
+			{
+				b = d;
+				return false;
+			}
+
+			if(d.f <= phi.bound)
+				a = d;
+
+			else
+				b = d;
+		}
+
+		return false;
+	}
+
+	/// The secant step, repeated on the side of the bracket that was updated (S1-S4)
+	template <class P>
+	bool secant2 (P& phi, Point& a, Point& b)
+	{
+		Float c = secant(a, b);
+		Point A = a, B = b;
+
+		if(update(phi, A, B, c))
+			return true;
+
+		if(c == B.a && update(phi, A, B, secant(b, B)))
+			return true;
+
+		if(c == A.a && update(phi, A, B, secant(a, A)))
+			return true;
+
+		a = A;
+		b = B;
+
+		return false;
+	}
+
+	static Float secant (const Point& a, const Point& b)
+	{
+		return (a.a * b.g - b.a * a.g) / (b.g - a.g);
+	}
+
+
+	Float delta;		///< Sufficient decrease factor
+	Float sigma;		///< Curvature factor
+	Float epsilon;		///< Relative error of the function values allowed by the approximate conditions
+	Float theta;		///< Position of the bisection point
+	Float gamma;		///< Minimum reduction of the bracket, below which a bisection is done
+	Float rho;			///< Expansion factor of the bracketing phase
+	int maxIterations;
+
+	Float psi0 = 0.01;	///< Factor of the first step
+	Float psi1 = 0.1;	///< Factor of the previous step used for the quadratic fit
+	Float psi2 = 2.0;	///< Expansion of the previous step when the fit fails
+
+	Float aPrev = 0.0;			///< The last accepted step
+	bool approximate = false;	///< If the approximate Wolfe conditions are used
+};
+
+} // namespace hz
+
+
+namespace impl
+{
+
+namespace params
+{
+
+template <class Params_>
+struct CGDescent : public Params_
+{
+	CPPOPT_USING_PARAMS(Params, Params_);
+	using Params::Params;
+
+
+	types::Float eta = 0.01;				///< Lower bound of the factor, relative to the gradient and direction norms
+
+	types::Float restartFactor = 6.0;		///< The direction is reset every @c restartFactor * N iterations
+
+	types::Float approximateFactor = 1e-3;	///< Relative change of the function below which the approximate conditions are used
+
+	types::Float decay = 0.7;				///< Decay of the average of the function values
+};
+
+} // namespace params
+
+
+template <class Params_>
+struct CGDescent : public params::CGDescent<Params_>
+{
+	CPPOPT_USING_PARAMS_CG_DESCENT(Params, params::CGDescent<Params_>);
+	using Params::Params;
+
+
+	template <class Function, class V>
+	V optimize (Function f, V x)
+	{
+		using Float = impl::Scalar<V>;
+
+		V fa(x.rows(), x.cols()), fb(x.rows(), x.cols()), dir(x.rows(), x.cols()), xn(x.rows(), x.cols());
+
+		Float fx = f(x, fa);
+
+		dir = -fa;
+
+		/// Weighted average of |f|, the scale of the change that switches to the approximate conditions
+		Float Q = 0.0, C = 0.0;
+
+		int restart = std::max<int>(1, restartFactor * x.size());
+
+		for(int iter = 0; iter < stop.maxIterations(); ++iter)
+		{
+			Float f0 = fx;
+
+			lineSearch(f, x, dir, fx, fa, xn, fb);
+
+			x.swap(xn);
+
+			if(stop(*this, x, fx, fb))
+				break;
+
+			Q = 1.0 + decay * Q;
+			C = C + (std::abs(fx) - C) / Q;
+
+			if(std::abs(fx - f0) <= approximateFactor * C)
+				lineSearch.approximate = true;
+
+			auto p = impl::cgProducts(fa, fb, dir);
+
+			Float beta = std::max(HZ{}(p), Float(-1.0 / (std::sqrt(p.dd) * std::min<Float>(eta, std::sqrt(p.aa)))));
+
+			/// The new direction has slope beta * bd - bb, so a restart is also taken if it is not of descent
+			if((iter + 1) % restart == 0 || !(beta * p.bd - p.bb < 0.0))
+				dir = -fb;
+
+			else
+				dir = beta * dir - fb;
+
+			fa.swap(fb);
+
+			output(*this, x, fx, fa);
+		}
+
+		return x;
+	}
+};
+
+} // namespace impl
+
+
+template <class LineSearch = hz::ApproximateWolfe<>, class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<0>>
+struct CGDescent : public impl::CGDescent<params::LineSearchOptimizer<LineSearch, Stop, Output>>,
+				   public GradientOptimizer<CGDescent<LineSearch, Stop, Output>>
+{
+	CPPOPT_USING_PARAMS(Impl, impl::CGDescent<params::LineSearchOptimizer<LineSearch, Stop, Output>>);
+	using Impl::Impl;
+
+	template <class Function, class V>
+	V optimize (Function f, V x)
+	{
+		return Impl::optimize(f, x);
+	}
+};
+
+
+} // namespace nlpp
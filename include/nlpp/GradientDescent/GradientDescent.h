@@ -47,12 +47,10 @@ struct GradientDescent : public Params_
 		{
 			dir = -gx;
 
-			auto alpha = lineSearch(f, x, dir);
+			auto alpha = lineSearch(f, x, dir, fx, gx);
 
 			x = x + alpha * dir;
 
-			fx = f(x, gx);
-
 			if(stop(*this, x, fx, gx))
 				break;
 
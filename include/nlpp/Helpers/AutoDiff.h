@@ -0,0 +1,880 @@
+/** @file
+
+    @brief Forward mode automatic differentiation for scalar multivariable functions
+
+    @details A @c Dual number carries a value and the derivatives of this value with respect to @c Lanes directions
+             at once. Evaluating a templated functor with a vector of duals, where each lane seeds a different
+             coordinate, gives @c Lanes exact partial derivatives in a single pass. The gradient of a function of
+             @c N variables then costs @c N/Lanes evaluations with the dual type.
+
+             The functor must be generic in the scalar type, that is, taking an @c Eigen::MatrixBase<Derived> and
+             returning @c Derived::Scalar. Math functions must be called unqualified (<tt>using std::sin; sin(x)</tt>)
+             so the dual overloads are found:
+
+    @snippet AutoDiff.cpp AutoDiff snippet
+
+    @details For many variables, ad::Reverse records the operations of a single evaluation with @c Var scalars in a
+             tape and sweeps it backwards, so the gradient costs a constant multiple of one function call. It is
+             given explicitly, as in <tt>optimizer(f, ad::reverse(f), x0)</tt>.
+
+    @note The wrap::FunctionGradient alias chooses ad::Gradient over finite differences whenever a function
+          functor can be called with a vector of duals. A functor with deduced return type is instantiated with
+          duals to check this.
+**/
+
+#pragma once
+
+#include <vector>
+
+#include "Helpers.h"
+
+
+namespace nlpp
+{
+
+/// Automatic differentiation namespace
+namespace ad
+{
+
+/** @brief Dual number with @c Lanes derivative directions
+ *
+ *  @tparam Float Base floating point type
+ *  @tparam Lanes Number of derivative directions carried together
+*/
+template <typename Float, int Lanes>
+struct Dual
+{
+    using Derivatives = Eigen::Array<Float, Lanes, 1>;
+
+
+    Dual (Float a = Float(0)) : a(a), d(Derivatives::Zero()) {}
+
+    Dual (Float a, const Derivatives& d) : a(a), d(d) {}
+
+
+    Dual& operator += (const Dual& x) { a += x.a; d += x.d; return *this; }
+    Dual& operator -= (const Dual& x) { a -= x.a; d -= x.d; return *this; }
+    Dual& operator *= (const Dual& x) { d = d * x.a + a * x.d; a *= x.a; return *this; }
+    Dual& operator /= (const Dual& x) { d = (d * x.a - a * x.d) / (x.a * x.a); a /= x.a; return *this; }
+
+
+    Float a;            ///< Value
+
+    Derivatives d;      ///< Derivatives for each lane
+};
+
+
+/** @name
+ *  @brief Arithmetic operators
+*/
+//@{
+template <typename Float, int Lanes>
+Dual<Float, Lanes> operator + (const Dual<Float, Lanes>& x) { return x; }
+
+template <typename Float, int Lanes>
+Dual<Float, Lanes> operator - (const Dual<Float, Lanes>& x) { return Dual<Float, Lanes>(-x.a, -x.d); }
+
+
+template <typename Float, int Lanes>
+Dual<Float, Lanes> operator + (const Dual<Float, Lanes>& x, const Dual<Float, Lanes>& y) { return Dual<Float, Lanes>(x.a + y.a, x.d + y.d); }
+
+template <typename Float, int Lanes>
+Dual<Float, Lanes> operator - (const Dual<Float, Lanes>& x, const Dual<Float, Lanes>& y) { return Dual<Float, Lanes>(x.a - y.a, x.d - y.d); }
+
+template <typename Float, int Lanes>
+Dual<Float, Lanes> operator * (const Dual<Float, Lanes>& x, const Dual<Float, Lanes>& y) { return Dual<Float, Lanes>(x.a * y.a, x.d * y.a + x.a * y.d); }
+
+template <typename Float, int Lanes>
+Dual<Float, Lanes> operator / (const Dual<Float, Lanes>& x, const Dual<Float, Lanes>& y)
+{
+    return Dual<Float, Lanes>(x.a / y.a, (x.d * y.a - x.a * y.d) / (y.a * y.a));
+}
+
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> operator + (const Dual<Float, Lanes>& x, T y) { return Dual<Float, Lanes>(x.a + y, x.d); }
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> operator + (T x, const Dual<Float, Lanes>& y) { return Dual<Float, Lanes>(x + y.a, y.d); }
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> operator - (const Dual<Float, Lanes>& x, T y) { return Dual<Float, Lanes>(x.a - y, x.d); }
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> operator - (T x, const Dual<Float, Lanes>& y) { return Dual<Float, Lanes>(x - y.a, -y.d); }
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> operator * (const Dual<Float, Lanes>& x, T y) { return Dual<Float, Lanes>(x.a * y, x.d * Float(y)); }
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> operator * (T x, const Dual<Float, Lanes>& y) { return Dual<Float, Lanes>(x * y.a, Float(x) * y.d); }
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> operator / (const Dual<Float, Lanes>& x, T y) { return Dual<Float, Lanes>(x.a / y, x.d / Float(y)); }
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> operator / (T x, const Dual<Float, Lanes>& y) { return Dual<Float, Lanes>(x / y.a, -Float(x) * y.d / (y.a * y.a)); }
+//@}
+
+
+/** @name
+ *  @brief Comparisons only take the value into account
+*/
+//@{
+#define NLPP_AD_COMPARISON(OP)                                                                                          \
+template <typename Float, int Lanes>                                                                                    \
+bool operator OP (const Dual<Float, Lanes>& x, const Dual<Float, Lanes>& y) { return x.a OP y.a; }                      \
+                                                                                                                        \
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>               \
+bool operator OP (const Dual<Float, Lanes>& x, T y) { return x.a OP y; }                                                \
+                                                                                                                        \
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>               \
+bool operator OP (T x, const Dual<Float, Lanes>& y) { return x OP y.a; }
+
+NLPP_AD_COMPARISON(<)
+NLPP_AD_COMPARISON(<=)
+NLPP_AD_COMPARISON(>)
+NLPP_AD_COMPARISON(>=)
+NLPP_AD_COMPARISON(==)
+NLPP_AD_COMPARISON(!=)
+
+#undef NLPP_AD_COMPARISON
+//@}
+
+
+/** @name
+ *  @brief Math functions, found by argument dependent lookup
+ *
+ *  @details Each function @f$g@f$ maps the dual @f$(a, d)@f$ to @f$(g(a), g'(a) d)@f$.
+*/
+//@{
+#define NLPP_AD_FUNCTION(NAME, VALUE, DERIVATIVE)                   \
+template <typename Float, int Lanes>                                \
+Dual<Float, Lanes> NAME (const Dual<Float, Lanes>& x)               \
+{                                                                   \
+    using std::sqrt; using std::exp; using std::log;                \
+    using std::sin; using std::cos; using std::tan;                 \
+    using std::sinh; using std::cosh; using std::tanh;              \
+    using std::asin; using std::acos; using std::atan;              \
+                                                                    \
+    const Float& a = x.a;                                           \
+    Float value = VALUE;                                            \
+                                                                    \
+    return Dual<Float, Lanes>(value, Float(DERIVATIVE) * x.d);      \
+}
+
+NLPP_AD_FUNCTION(sqrt, sqrt(a), 0.5 / value)
+NLPP_AD_FUNCTION(exp, exp(a), value)
+NLPP_AD_FUNCTION(log, log(a), 1.0 / a)
+NLPP_AD_FUNCTION(sin, sin(a), cos(a))
+NLPP_AD_FUNCTION(cos, cos(a), -sin(a))
+NLPP_AD_FUNCTION(tan, tan(a), 1.0 + value * value)
+NLPP_AD_FUNCTION(sinh, sinh(a), cosh(a))
+NLPP_AD_FUNCTION(cosh, cosh(a), sinh(a))
+NLPP_AD_FUNCTION(tanh, tanh(a), 1.0 - value * value)
+NLPP_AD_FUNCTION(asin, asin(a), 1.0 / sqrt(1.0 - a * a))
+NLPP_AD_FUNCTION(acos, acos(a), -1.0 / sqrt(1.0 - a * a))
+NLPP_AD_FUNCTION(atan, atan(a), 1.0 / (1.0 + a * a))
+NLPP_AD_FUNCTION(abs, a < 0 ? -a : a, a < 0 ? -1.0 : 1.0)
+
+#undef NLPP_AD_FUNCTION
+
+
+template <typename Float, int Lanes>
+Dual<Float, Lanes> abs2 (const Dual<Float, Lanes>& x)
+{
+    return x * x;
+}
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> pow (const Dual<Float, Lanes>& x, T p)
+{
+    using std::pow;
+
+    return Dual<Float, Lanes>(pow(x.a, p), Float(p * pow(x.a, p - 1)) * x.d);
+}
+
+template <typename Float, int Lanes, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Dual<Float, Lanes> pow (T x, const Dual<Float, Lanes>& p)
+{
+    using std::pow; using std::log;
+
+    Float value = pow(Float(x), p.a);
+
+    return Dual<Float, Lanes>(value, value * log(Float(x)) * p.d);
+}
+
+template <typename Float, int Lanes>
+Dual<Float, Lanes> pow (const Dual<Float, Lanes>& x, const Dual<Float, Lanes>& p)
+{
+    return exp(p * log(x));
+}
+//@}
+
+
+
+/** @brief Check if the function functor @c T can be evaluated with a vector @c V of a (differentiation) scalar type,
+ *         returning this same scalar type
+ *
+ *  @details Same precedence as wrap::FunctionType: a @c function member first, then @c operator().
+*/
+template <class T, class V>
+struct ScalarFunctionType
+{
+    using S = ::nlpp::impl::Scalar<V>;
+
+    /// If T has an function member `S function(V)`
+    template <class U = T, std::enable_if_t<std::is_same<std::decay_t<decltype(std::declval<U>().function(std::declval<V>()))>, S>::value, int> = 0>
+    static constexpr int impl (::nlpp::impl::Precedence<0>) { return 0; }
+
+    /// If T has an function member `S operator()(V)`
+    template <class U = T, std::enable_if_t<std::is_same<std::decay_t<decltype(std::declval<U>().operator()(std::declval<V>()))>, S>::value, int> = 0>
+    static constexpr int impl (::nlpp::impl::Precedence<1>) { return 1; }
+
+    /// Otherwise return false
+    static constexpr int impl (...) { return -1; }
+
+
+    enum{ value = impl(::nlpp::impl::Precedence<0>{}) };
+};
+
+/// Check if the function functor @c T can be evaluated with a vector of duals
+template <class T, class V>
+struct IsDualFunction : std::integral_constant<bool, (ScalarFunctionType<T, Eigen::Matrix<Dual<::nlpp::impl::Scalar<V>, 1>, V::RowsAtCompileTime, V::ColsAtCompileTime>>::value >= 0)> {};
+
+/** @brief Check if the function functor @c T is differentiated automatically when wrapped
+ * 
+ *  @details Only functors tagged with ad::Differentiable are tried with duals, so the body of an untagged generic functor is
+ *           never instantiated with a scalar it may not support.
+*/
+template <class T, class V>
+struct IsDifferentiable : std::conjunction<std::is_base_of<Differentiable, T>, IsDualFunction<T, V>> {};
+
+
+/** @name
+ *  @brief Delegate to @c f.function or @c f.operator() with a vector of a differentiation scalar type
+*/
+//@{
+template <class Function, class V, std::enable_if_t<ScalarFunctionType<Function, ::nlpp::impl::Plain<V>>::value == 0, int> = 0>
+auto call (Function& f, const Eigen::MatrixBase<V>& y)
+{
+    return f.function(y.derived());
+}
+
+template <class Function, class V, std::enable_if_t<ScalarFunctionType<Function, ::nlpp::impl::Plain<V>>::value != 0, int> = 0>
+auto call (Function& f, const Eigen::MatrixBase<V>& y)
+{
+    return f(y.derived());
+}
+//@}
+
+
+
+/** @brief Forward mode automatic differentiation gradient
+ *
+ *  @details The coordinates are seeded @c Lanes at a time, so a gradient of @c N variables costs
+ *           <tt>ceil(N / Lanes)</tt> dual evaluations of @c f. The function value comes for free in each of them.
+ *
+ *  @tparam Function Functor generic on the scalar type
+ *  @tparam Lanes Number of coordinates differentiated per evaluation
+*/
+template <class Function, int Lanes>
+struct Gradient
+{
+    Gradient (const Function& f = Function{}) : f(f) {}
+
+
+    /** @name
+     *  @brief Function and gradient in the same dual passes
+     *
+     *  @param x The point where we evaluate the gradient
+     *  @param g A reference to where we will write the gradient of @c f calculated at @c x
+    */
+    //@{
+    template <class V>
+    ::nlpp::impl::Scalar<V> functionGradient (const Eigen::MatrixBase<V>& x, ::nlpp::impl::Plain<V>& g)
+    {
+        using D = Dual<::nlpp::impl::Scalar<V>, Lanes>;
+
+        Eigen::Matrix<D, V::RowsAtCompileTime, V::ColsAtCompileTime> y = x.template cast<D>();
+
+        g.resize(x.rows(), x.cols());
+
+        D fy = x.size() ? D() : call(f, y);
+
+        for(int b = 0; b < x.size(); b += Lanes)
+        {
+            int k = std::min(Lanes, int(x.size()) - b);
+
+            for(int j = 0; j < k; ++j)
+                y(b + j).d(j) = 1.0;
+
+            fy = call(f, y);
+
+            for(int j = 0; j < k; ++j)
+                g(b + j) = fy.d(j), y(b + j).d(j) = 0.0;
+        }
+
+        return fy.a;
+    }
+
+    template <class V>
+    auto functionGradient (const Eigen::MatrixBase<V>& x)
+    {
+        ::nlpp::impl::Plain<V> g;
+
+        auto fx = functionGradient(x, g);
+
+        return std::make_pair(fx, g);
+    }
+    //@}
+
+
+    template <class V>
+    void gradient (const Eigen::MatrixBase<V>& x, ::nlpp::impl::Plain<V>& g)
+    {
+        functionGradient(x, g);
+    }
+
+    template <class V>
+    ::nlpp::impl::Plain<V> gradient (const Eigen::MatrixBase<V>& x)
+    {
+        return std::get<1>(functionGradient(x));
+    }
+
+    /// The value of @c fx is not needed, the overload only matches the finite difference interface
+    template <class V>
+    void gradient (const Eigen::MatrixBase<V>& x, ::nlpp::impl::Plain<V>& g, ::nlpp::impl::Scalar<V>)
+    {
+        functionGradient(x, g);
+    }
+
+
+    /** @brief Directional derivative @f$\nabla f(x)^\intercal e@f$ in a single dual pass
+     *  @note The value @c fx is ignored, it only matches the finite difference interface
+    */
+    //@{
+    template <class V, class U>
+    ::nlpp::impl::Scalar<V> directional (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& e)
+    {
+        using D = Dual<::nlpp::impl::Scalar<V>, 1>;
+
+        Eigen::Matrix<D, V::RowsAtCompileTime, V::ColsAtCompileTime> y(x.rows(), x.cols());
+
+        for(int i = 0; i < x.size(); ++i)
+            y(i) = D(x(i), typename D::Derivatives(e(i)));
+
+        return call(f, y).d(0);
+    }
+
+    template <class V, class U>
+    ::nlpp::impl::Scalar<V> directional (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& e, ::nlpp::impl::Scalar<V>)
+    {
+        return directional(x, e);
+    }
+    //@}
+
+
+    template <class V>
+    ::nlpp::impl::Plain<V> operator () (const Eigen::MatrixBase<V>& x)
+    {
+        return gradient(x);
+    }
+
+    template <class V>
+    void operator () (const Eigen::MatrixBase<V>& x, ::nlpp::impl::Plain<V>& g)
+    {
+        gradient(x, g);
+    }
+
+
+    Function f;     ///< Functor variable
+};
+
+
+/// Delegate the call to Gradient<Function, Lanes>
+template <int Lanes = 8, class Function>
+auto gradient (const Function& f)
+{
+    return Gradient<Function, Lanes>(f);
+}
+
+
+
+/** @brief Arena of the operations recorded during a reverse mode evaluation
+ *
+ *  @details Each node stores the (at most two) nodes it depends on, with the local partial derivatives. The
+ *           storage is only cleared between evaluations, never freed, so after the first gradient no more
+ *           allocations happen. Operations on @c Var are recorded in the active tape of the calling thread.
+*/
+template <typename Float>
+struct Tape
+{
+    struct Node
+    {
+        int parents[2];
+        Float partials[2];
+    };
+
+
+    /// Record a new node, returning its index
+    int push (int p0 = -1, Float w0 = Float(0), int p1 = -1, Float w1 = Float(0))
+    {
+        nodes.push_back(Node{{p0, p1}, {w0, w1}});
+
+        return int(nodes.size()) - 1;
+    }
+
+    /// Reset the arena, keeping its memory
+    void clear ()
+    {
+        nodes.clear();
+    }
+
+    /// Propagate the adjoints from the node @c output back to every node recorded before it
+    void backward (int output)
+    {
+        adjoints.assign(nodes.size(), Float(0));
+
+        if(output < 0)
+            return;
+
+        adjoints[output] = Float(1);
+
+        for(int k = output; k >= 0; --k)
+        {
+            if(adjoints[k] == Float(0))
+                continue;
+
+            const Node& node = nodes[k];
+
+            for(int p = 0; p < 2; ++p)
+                if(node.parents[p] >= 0)
+                    adjoints[node.parents[p]] += node.partials[p] * adjoints[k];
+        }
+    }
+
+
+    /// The tape where the current thread records its operations (if any)
+    static Tape*& active ()
+    {
+        static thread_local Tape* tape = nullptr;
+
+        return tape;
+    }
+
+
+    std::vector<Node> nodes;        ///< Recorded operations
+
+    std::vector<Float> adjoints;    ///< Adjoints of each node after a call to @c backward
+};
+
+
+/** @brief Reverse mode scalar, a value and the index of the node that created it in the active tape
+ *  @note Constants (and any value created without an active tape) have index -1 and are never recorded
+*/
+template <typename Float>
+struct Var
+{
+    Var (Float a = Float(0)) : a(a), i(-1) {}
+
+    Var (Float a, int i) : a(a), i(i) {}
+
+
+    /// Record a node depending on @c p0 and @c p1, unless none of them is recorded
+    static int record (int p0, Float w0, int p1 = -1, Float w1 = Float(0))
+    {
+        Tape<Float>* tape = Tape<Float>::active();
+
+        if(!tape || (p0 < 0 && p1 < 0))
+            return -1;
+
+        return tape->push(p0, w0, p1, w1);
+    }
+
+
+    Var& operator += (const Var& x) { return *this = *this + x; }
+    Var& operator -= (const Var& x) { return *this = *this - x; }
+    Var& operator *= (const Var& x) { return *this = *this * x; }
+    Var& operator /= (const Var& x) { return *this = *this / x; }
+
+
+    Float a;    ///< Value
+
+    int i;      ///< Node index
+};
+
+
+/** @name
+ *  @brief Arithmetic operators of the reverse mode scalar
+*/
+//@{
+template <typename Float>
+Var<Float> operator + (const Var<Float>& x) { return x; }
+
+template <typename Float>
+Var<Float> operator - (const Var<Float>& x) { return Var<Float>(-x.a, Var<Float>::record(x.i, -1)); }
+
+
+template <typename Float>
+Var<Float> operator + (const Var<Float>& x, const Var<Float>& y) { return Var<Float>(x.a + y.a, Var<Float>::record(x.i, 1, y.i, 1)); }
+
+template <typename Float>
+Var<Float> operator - (const Var<Float>& x, const Var<Float>& y) { return Var<Float>(x.a - y.a, Var<Float>::record(x.i, 1, y.i, -1)); }
+
+template <typename Float>
+Var<Float> operator * (const Var<Float>& x, const Var<Float>& y) { return Var<Float>(x.a * y.a, Var<Float>::record(x.i, y.a, y.i, x.a)); }
+
+template <typename Float>
+Var<Float> operator / (const Var<Float>& x, const Var<Float>& y)
+{
+    return Var<Float>(x.a / y.a, Var<Float>::record(x.i, 1 / y.a, y.i, -x.a / (y.a * y.a)));
+}
+
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> operator + (const Var<Float>& x, T y) { return Var<Float>(x.a + y, Var<Float>::record(x.i, 1)); }
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> operator + (T x, const Var<Float>& y) { return Var<Float>(x + y.a, Var<Float>::record(y.i, 1)); }
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> operator - (const Var<Float>& x, T y) { return Var<Float>(x.a - y, Var<Float>::record(x.i, 1)); }
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> operator - (T x, const Var<Float>& y) { return Var<Float>(x - y.a, Var<Float>::record(y.i, -1)); }
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> operator * (const Var<Float>& x, T y) { return Var<Float>(x.a * y, Var<Float>::record(x.i, y)); }
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> operator * (T x, const Var<Float>& y) { return Var<Float>(x * y.a, Var<Float>::record(y.i, x)); }
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> operator / (const Var<Float>& x, T y) { return Var<Float>(x.a / y, Var<Float>::record(x.i, 1 / Float(y))); }
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> operator / (T x, const Var<Float>& y) { return Var<Float>(x / y.a, Var<Float>::record(y.i, -x / (y.a * y.a))); }
+//@}
+
+
+/** @name
+ *  @brief Comparisons only take the value into account
+*/
+//@{
+#define NLPP_AD_COMPARISON(OP)                                                                              \
+template <typename Float>                                                                                   \
+bool operator OP (const Var<Float>& x, const Var<Float>& y) { return x.a OP y.a; }                          \
+                                                                                                            \
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>              \
+bool operator OP (const Var<Float>& x, T y) { return x.a OP y; }                                            \
+                                                                                                            \
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>              \
+bool operator OP (T x, const Var<Float>& y) { return x OP y.a; }
+
+NLPP_AD_COMPARISON(<)
+NLPP_AD_COMPARISON(<=)
+NLPP_AD_COMPARISON(>)
+NLPP_AD_COMPARISON(>=)
+NLPP_AD_COMPARISON(==)
+NLPP_AD_COMPARISON(!=)
+
+#undef NLPP_AD_COMPARISON
+//@}
+
+
+/** @name
+ *  @brief Math functions of the reverse mode scalar, recording @f$g'(a)@f$ as the local partial
+*/
+//@{
+#define NLPP_AD_FUNCTION(NAME, VALUE, DERIVATIVE)                   \
+template <typename Float>                                           \
+Var<Float> NAME (const Var<Float>& x)                               \
+{                                                                   \
+    using std::sqrt; using std::exp; using std::log;                \
+    using std::sin; using std::cos; using std::tan;                 \
+    using std::sinh; using std::cosh; using std::tanh;              \
+    using std::asin; using std::acos; using std::atan;              \
+                                                                    \
+    const Float& a = x.a;                                           \
+    Float value = VALUE;                                            \
+                                                                    \
+    return Var<Float>(value, Var<Float>::record(x.i, DERIVATIVE));  \
+}
+
+NLPP_AD_FUNCTION(sqrt, sqrt(a), 0.5 / value)
+NLPP_AD_FUNCTION(exp, exp(a), value)
+NLPP_AD_FUNCTION(log, log(a), 1.0 / a)
+NLPP_AD_FUNCTION(sin, sin(a), cos(a))
+NLPP_AD_FUNCTION(cos, cos(a), -sin(a))
+NLPP_AD_FUNCTION(tan, tan(a), 1.0 + value * value)
+NLPP_AD_FUNCTION(sinh, sinh(a), cosh(a))
+NLPP_AD_FUNCTION(cosh, cosh(a), sinh(a))
+NLPP_AD_FUNCTION(tanh, tanh(a), 1.0 - value * value)
+NLPP_AD_FUNCTION(asin, asin(a), 1.0 / sqrt(1.0 - a * a))
+NLPP_AD_FUNCTION(acos, acos(a), -1.0 / sqrt(1.0 - a * a))
+NLPP_AD_FUNCTION(atan, atan(a), 1.0 / (1.0 + a * a))
+NLPP_AD_FUNCTION(abs, a < 0 ? -a : a, a < 0 ? -1.0 : 1.0)
+
+#undef NLPP_AD_FUNCTION
+
+
+template <typename Float>
+Var<Float> abs2 (const Var<Float>& x)
+{
+    return x * x;
+}
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> pow (const Var<Float>& x, T p)
+{
+    using std::pow;
+
+    return Var<Float>(pow(x.a, p), Var<Float>::record(x.i, p * pow(x.a, p - 1)));
+}
+
+template <typename Float, typename T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+Var<Float> pow (T x, const Var<Float>& p)
+{
+    using std::pow; using std::log;
+
+    Float value = pow(Float(x), p.a);
+
+    return Var<Float>(value, Var<Float>::record(p.i, value * log(Float(x))));
+}
+
+template <typename Float>
+Var<Float> pow (const Var<Float>& x, const Var<Float>& p)
+{
+    return exp(p * log(x));
+}
+//@}
+
+
+
+/** @brief Reverse mode automatic differentiation gradient
+ *
+ *  @details The function is evaluated once with @c Var scalars, recording every operation in a tape, and then the
+ *           tape is swept backwards once. So the gradient costs a small constant multiple of a function call,
+ *           independently of the number of variables. The tape is kept between calls and reused.
+ *
+ *  @tparam Function Functor generic on the scalar type
+ *  @tparam Float Base floating point type
+ *
+ *  @note The tape grows with the number of operations of a single call to @c f
+*/
+template <class Function, typename Float>
+struct Reverse
+{
+    Reverse (const Function& f = Function{}) : f(f) {}
+
+
+    /** @name
+     *  @brief Function and gradient in a single recording
+     *
+     *  @param x The point where we evaluate the gradient
+     *  @param g A reference to where we will write the gradient of @c f calculated at @c x
+    */
+    //@{
+    template <class V>
+    ::nlpp::impl::Scalar<V> functionGradient (const Eigen::MatrixBase<V>& x, ::nlpp::impl::Plain<V>& g)
+    {
+        using Tape = ::nlpp::ad::Tape<Float>;
+
+        Tape* previous = Tape::active();
+        Tape::active() = &tape;
+
+        tape.clear();
+
+        Eigen::Matrix<Var<Float>, V::RowsAtCompileTime, V::ColsAtCompileTime> y(x.rows(), x.cols());
+
+        for(int i = 0; i < x.size(); ++i)
+            y(i) = Var<Float>(x(i), tape.push());
+
+        Var<Float> fy;
+
+        try
+        {
+            fy = call(f, y);
+        }
+        catch(...)
+        {
+            Tape::active() = previous;
+            throw;
+        }
+
+        Tape::active() = previous;
+
+        tape.backward(fy.i);
+
+        g.resize(x.rows(), x.cols());
+
+        for(int i = 0; i < x.size(); ++i)
+            g(i) = fy.i >= 0 ? tape.adjoints[i] : Float(0);
+
+        return fy.a;
+    }
+
+    template <class V>
+    auto functionGradient (const Eigen::MatrixBase<V>& x)
+    {
+        ::nlpp::impl::Plain<V> g;
+
+        auto fx = functionGradient(x, g);
+
+        return std::make_pair(fx, g);
+    }
+    //@}
+
+
+    template <class V>
+    void gradient (const Eigen::MatrixBase<V>& x, ::nlpp::impl::Plain<V>& g)
+    {
+        functionGradient(x, g);
+    }
+
+    template <class V>
+    ::nlpp::impl::Plain<V> gradient (const Eigen::MatrixBase<V>& x)
+    {
+        return std::get<1>(functionGradient(x));
+    }
+
+    /// The value of @c fx is not needed, the overload only matches the finite difference interface
+    template <class V>
+    void gradient (const Eigen::MatrixBase<V>& x, ::nlpp::impl::Plain<V>& g, ::nlpp::impl::Scalar<V>)
+    {
+        functionGradient(x, g);
+    }
+
+
+    /// Directional derivative @f$\nabla f(x)^\intercal e@f$, from the full gradient
+    //@{
+    template <class V, class U>
+    ::nlpp::impl::Scalar<V> directional (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& e)
+    {
+        return gradient(x).dot(e);
+    }
+
+    template <class V, class U>
+    ::nlpp::impl::Scalar<V> directional (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& e, ::nlpp::impl::Scalar<V>)
+    {
+        return directional(x, e);
+    }
+    //@}
+
+
+    template <class V>
+    ::nlpp::impl::Plain<V> operator () (const Eigen::MatrixBase<V>& x)
+    {
+        return gradient(x);
+    }
+
+    template <class V>
+    void operator () (const Eigen::MatrixBase<V>& x, ::nlpp::impl::Plain<V>& g)
+    {
+        gradient(x, g);
+    }
+
+
+    Function f;             ///< Functor variable
+
+    Tape<Float> tape;       ///< Operations of the last call, reused by the next
+};
+
+
+/// Delegate the call to Reverse<Function, Float>
+template <typename Float = types::Float, class Function>
+auto reverse (const Function& f)
+{
+    return Reverse<Function, Float>(f);
+}
+
+} // namespace ad
+
+} // namespace nlpp
+
+
+
+namespace Eigen
+{
+
+/// Lets Eigen matrices and expressions hold dual numbers
+template <typename Float, int Lanes>
+struct NumTraits<::nlpp::ad::Dual<Float, Lanes>> : NumTraits<Float>
+{
+    using Real = ::nlpp::ad::Dual<Float, Lanes>;
+    using NonInteger = ::nlpp::ad::Dual<Float, Lanes>;
+    using Nested = ::nlpp::ad::Dual<Float, Lanes>;
+    using Literal = Float;
+
+    enum
+    {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = (Lanes + 1) * NumTraits<Float>::ReadCost,
+        AddCost = (Lanes + 1) * NumTraits<Float>::AddCost,
+        MulCost = (2 * Lanes + 1) * NumTraits<Float>::MulCost
+    };
+
+    static inline Real epsilon () { return Real(NumTraits<Float>::epsilon()); }
+    static inline Real dummy_precision () { return Real(NumTraits<Float>::dummy_precision()); }
+    static inline Real highest () { return Real(NumTraits<Float>::highest()); }
+    static inline Real lowest () { return Real(NumTraits<Float>::lowest()); }
+    static inline int digits10 () { return NumTraits<Float>::digits10(); }
+};
+
+template <typename Float, int Lanes, typename BinaryOp>
+struct ScalarBinaryOpTraits<::nlpp::ad::Dual<Float, Lanes>, Float, BinaryOp>
+{
+    using ReturnType = ::nlpp::ad::Dual<Float, Lanes>;
+};
+
+template <typename Float, int Lanes, typename BinaryOp>
+struct ScalarBinaryOpTraits<Float, ::nlpp::ad::Dual<Float, Lanes>, BinaryOp>
+{
+    using ReturnType = ::nlpp::ad::Dual<Float, Lanes>;
+};
+
+
+/// Lets Eigen matrices and expressions hold reverse mode scalars
+template <typename Float>
+struct NumTraits<::nlpp::ad::Var<Float>> : NumTraits<Float>
+{
+    using Real = ::nlpp::ad::Var<Float>;
+    using NonInteger = ::nlpp::ad::Var<Float>;
+    using Nested = ::nlpp::ad::Var<Float>;
+    using Literal = Float;
+
+    enum
+    {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = 2 * NumTraits<Float>::ReadCost,
+        AddCost = 4 * NumTraits<Float>::AddCost,
+        MulCost = 4 * NumTraits<Float>::MulCost
+    };
+
+    static inline Real epsilon () { return Real(NumTraits<Float>::epsilon()); }
+    static inline Real dummy_precision () { return Real(NumTraits<Float>::dummy_precision()); }
+    static inline Real highest () { return Real(NumTraits<Float>::highest()); }
+    static inline Real lowest () { return Real(NumTraits<Float>::lowest()); }
+    static inline int digits10 () { return NumTraits<Float>::digits10(); }
+};
+
+template <typename Float, typename BinaryOp>
+struct ScalarBinaryOpTraits<::nlpp::ad::Var<Float>, Float, BinaryOp>
+{
+    using ReturnType = ::nlpp::ad::Var<Float>;
+};
+
+template <typename Float, typename BinaryOp>
+struct ScalarBinaryOpTraits<Float, ::nlpp::ad::Var<Float>, BinaryOp>
+{
+    using ReturnType = ::nlpp::ad::Var<Float>;
+};
+
+} // namespace Eigen
@@ -18,6 +18,21 @@
 
     @snippet Helpers/FiniteDifference.cpp FiniteDifference step snippet
 
+    @details The @c ComplexStep difference evaluates the functor with complex vectors instead, giving gradients
+             accurate to machine precision with a tiny step, for functors generic on the scalar type.
+
+    @details The coordinate evaluations of the gradient can also be distributed over a thread pool by giving
+             the @c Parallel execution policy. Each worker holds its own copy of the functor and of @c x, so
+             stateful functors are safe, as long as they can be copied.
+
+    @details If the functor has a batch interface (see wrap::BatchFunctionType), taking a matrix whose columns are
+             points and returning a vector of function values, the perturbed points of gradients and hessians are
+             given to it in blocks of columns instead of one at a time.
+
+    @details When the gradient is exact, @c GradientHessian approximates the hessian from N+1 gradient calls, and a
+             hessian vector product from a single one. @c fd::hessian selects it for function/gradient wrappers whose
+             gradient is not a finite difference.
+
     @note Notice that the functor is copied into the finite difference classes. So be careful about
           lifetime issues for your objects.
 **/
@@ -26,8 +41,11 @@
 
 #pragma once
 
+#include <complex>
+
 #include "Helpers.h"
 #include "Wrappers.h"
+#include "ThreadPool.h"
 
 /** @defgroup FiniteDifferenceGroup Finite Difference
     @copydoc FiniteDifference.h
@@ -41,7 +59,8 @@
                                                   using NAME::hessian;       \
                                                   using NAME::directional;   \
                                                   using NAME::f;             \
-                                                  using NAME::step;
+                                                  using NAME::step;          \
+                                                  using NAME::execution;
 
 #define CPPOPT_USING_STEPSIZE(NAME, ...) using NAME = __VA_ARGS__;   \
                                          using NAME::NAME;           \
@@ -73,18 +92,31 @@ struct NormalizedStep;
 //@}
 
 
+/** @name
+    @brief Forward Declarations of the execution policies
+*/
+//@{
+struct Sequential;
+
+struct Parallel;
+//@}
+
+
 /** @name
     @brief Forward declaration of the main finite difference classes
 */
 //@{
-template <class, class>
+template <class, class, class>
 struct Forward;
 
-template <class, class>
+template <class, class, class>
 struct Backward;
 
-template <class, class>
+template <class, class, class>
 struct Central;
+
+template <class, class, class>
+struct ComplexStep;
 //@}
 
 
@@ -100,25 +132,36 @@ namespace traits
 template <class>
 struct FiniteDifference;
 
-template <class _Function, class _Step>
-struct FiniteDifference<Forward<_Function, _Step>>
+template <class _Function, class _Step, class _Execution>
+struct FiniteDifference<Forward<_Function, _Step, _Execution>>
+{
+    using Function = _Function;
+    using Step = _Step;
+    using Execution = _Execution;
+};
+
+template <class _Function, class _Step, class _Execution>
+struct FiniteDifference<Backward<_Function, _Step, _Execution>>
 {
     using Function = _Function;
     using Step = _Step;
+    using Execution = _Execution;
 };
 
-template <class _Function, class _Step>
-struct FiniteDifference<Backward<_Function, _Step>>
+template <class _Function, class _Step, class _Execution>
+struct FiniteDifference<Central<_Function, _Step, _Execution>>
 {
     using Function = _Function;
     using Step = _Step;
+    using Execution = _Execution;
 };
 
-template <class _Function, class _Step>
-struct FiniteDifference<Central<_Function, _Step>>
+template <class _Function, class _Step, class _Execution>
+struct FiniteDifference<ComplexStep<_Function, _Step, _Execution>>
 {
     using Function = _Function;
     using Step = _Step;
+    using Execution = _Execution;
 };
 //@}
 
@@ -131,6 +174,7 @@ struct FiniteDifference<Central<_Function, _Step>>
     @tparam Impl The base class that extends from FiniteDifference<Impl>. It must expose:
                  - @c Function: Functor type of which we want to take the derivatives of
                  - @c Step: Type of the infinitesinal step calculator functor
+                 - @c Execution: How the coordinate evaluations are executed (@c Sequential or @c Parallel)
                  - @c Float: Floating type
 
 */
@@ -143,13 +187,16 @@ struct FiniteDifference
     //@{
     using Function = typename traits::FiniteDifference<Impl>::Function;
     using Step = typename traits::FiniteDifference<Impl>::Step;
+    using Execution = typename traits::FiniteDifference<Impl>::Execution;
     //@}
 
     /** @brief Single base constructor
         @param f The functor type
         @param step Step size type
+        @param execution Execution policy
     */
-    FiniteDifference (const Function& f, const Step& step = Step{}) : f(f), step(step)
+    FiniteDifference (const Function& f, const Step& step = Step{}, const Execution& execution = Execution{}) :
+                      f(f), step(step), execution(execution)
     {
     }
 
@@ -268,9 +315,11 @@ struct FiniteDifference
     }
 
 
-    Function f;     ///< Functor variable
+    Function f;             ///< Functor variable
 
-    Step step;      ///< Step variable
+    Step step;              ///< Step variable
+
+    Execution execution;    ///< Execution policy of the coordinate evaluations
 };
 
 
@@ -287,12 +336,12 @@ struct FiniteDifference
  * 
  *  @tparam Function Functor type
  *  @tparam Step Step size template functor
- *  @tparam Float Base floating point type
+ *  @tparam Execution Execution policy of the gradient coordinates
 */
-template <class Function, class Step>
-struct Forward : public FiniteDifference<Forward<Function, Step>>
+template <class Function, class Step, class Execution>
+struct Forward : public FiniteDifference<Forward<Function, Step, Execution>>
 {
-    CPPOPT_USING_FINITE_DIFFERENCE(Base, FiniteDifference<Forward<Function, Step>>);
+    CPPOPT_USING_FINITE_DIFFERENCE(Base, FiniteDifference<Forward<Function, Step, Execution>>);
 
 
     /** @name
@@ -329,8 +378,8 @@ struct Forward : public FiniteDifference<Forward<Function, Step>>
     void gradient (const Eigen::MatrixBase<Derived>& x, ::nlpp::impl::Plain<Derived>& g, typename Derived::Scalar fx)
     {
         step.init(x);
-        
-        changeEval([&](const auto& x, int i, double h){ g(i) = (this->f(x) - fx) / h; }, x, step);
+
+        execution(f, x, [&](int i){ return step(x, i); }, [&](int i, auto fy, auto h){ g(i) = (fy - fx) / h; });
     }
 
 
@@ -381,42 +430,47 @@ struct Forward : public FiniteDifference<Forward<Function, Step>>
         Float h2 = h * h;
 
         impl::Plain<V> fxi(x.rows(), x.cols());
+        impl::Plain<V> y = x;
         impl::Plain2D<V> hess(x.size(), x.size());
 
-        changeEval([&](const auto& x, int i, double){ fxi(i) = this->f(x); }, x, h);
+        execution(f, x, [&](int){ return h; }, [&](int i, Float fy, Float){ fxi(i) = fy; });
 
-        changeEval([&](const auto& x, int i, double)
+        for(int i = 0; i < x.size(); ++i)
         {
-            changeEval([&](const auto& y, int j, double)
+            y(i) = x(i) + h;
+
+            execution(f, y, [&](int){ return h; }, [&](int j, Float fy, Float)
             {
-                hess(i, j) = hess(j, i) = (this->f(y) - fxi(i) - fxi(j) + fx) / h2;
-                
-            }, x, h, handy::range(0, x.size()));
-        }, x, h);
+                hess(i, j) = hess(j, i) = (fy - fxi(i) - fxi(j) + fx) / h2;
+
+            }, i, x.size());
+
+            y(i) = x(i);
+        }
 
         return hess;
     }
 
-    /** @brief Hessian calculation for multivariable @a vector functions at point @c x
+    /** @brief Jacobian calculation for multivariable @a vector functions at point @c x
      * 
      *  @details This is useful when you have, for example, the exact gradient function of @c f. This way,
-     *           we approximate the hessian of @c f by using N+1 gradient calls.
+     *           we approximate the hessian of @c f by using N+1 gradient calls (see GradientHessian).
      * 
      *  @param x Eigen::MatrixBase vector/matrix
      *  @param fx Vector result of @c f(x)
      *  @returns @f$ \nabla f(x) @f$
      */
-    // template <class Derived>
-    // auto hessian (const Eigen::MatrixBase<Derived>& x, const Eigen::MatrixBase<Derived>& fx)
-    // {
-    //     step.init(x);
+    template <class V, class U>
+    auto jacobian (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& fx)
+    {
+        using Float = impl::Scalar<V>;
 
-    //     Eigen::Matrix<typename Derived::Scalar, Derived::SizeAtCompileTime, Derived::SizeAtCompileTime> hess(x.size(), x.size());
+        Eigen::Matrix<Float, U::SizeAtCompileTime, V::SizeAtCompileTime> jac(fx.size(), x.size());
 
-    //     changeEval([&](const auto& x, int i, double h){ hess.col(i) = (this->f(x) - fx) / h; }, x, step);
+        execution(f, x, [&](int i){ return step(x, i); }, [&](int i, const auto& fy, Float h){ jac.col(i) = (fy - fx) / h; });
 
-    //     return hess;
-    // }
+        return jac;
+    }
 
     /** @brief Hessian vector product calculation at point @c x with direction @c e
      * 
@@ -472,7 +526,7 @@ struct Forward : public FiniteDifference<Forward<Function, Step>>
     template <class F, class Derived>
     static void changeEval (F f, const Eigen::MatrixBase<Derived>& x, typename Derived::Scalar inc)
     {
-        changeEval(f, x, [&](auto...){ return inc; });
+        changeEval(f, x, [&](auto&&...){ return inc; });
     }
 
     template <class F, class Derived, class StepSize, std::enable_if_t<!std::is_fundamental<StepSize>::value, int> = 0>
@@ -484,7 +538,7 @@ struct Forward : public FiniteDifference<Forward<Function, Step>>
     template <class F, class Derived, typename Int>
     static void changeEval (F f, const Eigen::MatrixBase<Derived>& x, typename Derived::Scalar inc, handy::Range<Int> range)
     {
-        changeEval(f, x, [&](auto...){ return inc; }, range);
+        changeEval(f, x, [&](auto&&...){ return inc; }, range);
     }
 
     template <class F, class Derived, class StepSize, typename Int, std::enable_if_t<!std::is_fundamental<StepSize>::value, int> = 0>
@@ -518,10 +572,10 @@ struct Forward : public FiniteDifference<Forward<Function, Step>>
  *  @tparam Step Step size template functor
  *  @tparam Float Base floating point type
 */
-template <class Function, class Step = AutoStep>
-struct Backward : public FiniteDifference<Backward<Function, Step>>
+template <class Function, class Step = AutoStep, class Execution = Sequential>
+struct Backward : public FiniteDifference<Backward<Function, Step, Execution>>
 {
-    CPPOPT_USING_FINITE_DIFFERENCE(Base, FiniteDifference<Backward<Function, Step>>);
+    CPPOPT_USING_FINITE_DIFFERENCE(Base, FiniteDifference<Backward<Function, Step, Execution>>);
 
 
     /** @name
@@ -537,7 +591,7 @@ struct Backward : public FiniteDifference<Backward<Function, Step>>
      *  @param e The direction to calculate the directional derivative of @f c at @c x in the direction of @c e
     */
     //@{
-    template <typename Float>
+    template <typename Float, std::enable_if_t<std::is_floating_point<Float>::value, int> = 0>
     auto gradient (Float x, Float fx)
     {
         return directional(x, 1.0, fx, step(x));
@@ -558,7 +612,7 @@ struct Backward : public FiniteDifference<Backward<Function, Step>>
     {
         step.init(x);
 
-        changeEval([&](const auto& x, int i, double h){ static_cast<impl::Plain<Derived>>(g)(i) = (fx - this->f(x)) / h; }, x, step);
+        execution(f, x, [&](int i){ return -step(x, i); }, [&](int i, auto fy, auto h){ g(i) = (fx - fy) / -h; });
     }
 
     // template <class Derived>
@@ -579,11 +633,11 @@ struct Backward : public FiniteDifference<Backward<Function, Step>>
      *           the hessian product: @f$\nabla^2 f(x) e$@f.
      * 
      *  @param x The scalar or Eigen::MatrixBase value where the hessian (or second difference, if scalar) of @c f will be evaluated
-     *  @param fx The result of @c f applied to @c x, that is, f(x). If it is a vector, we return the Jacobian of @c f.
+     *  @param fx The result of @c f applied to @c x, that is, f(x).
      *  @param e The direction to calculate the hessian vector product @f$\nabla^2 f(x) e$@f.
     */
     //@{
-    template <typename Float>
+    template <typename Float, std::enable_if_t<std::is_floating_point<Float>::value, int> = 0>
     auto hessian (Float x, Float fx)
     {
         Float h = step(x);
@@ -601,30 +655,23 @@ struct Backward : public FiniteDifference<Backward<Function, Step>>
         Float h2 = std::pow(step(x), 2);
 
         Eigen::Matrix<Float, Derived::RowsAtCompileTime, Derived::ColsAtCompileTime> fxi(x.rows(), x.cols());
+        Eigen::Matrix<Float, Derived::RowsAtCompileTime, Derived::ColsAtCompileTime> y = x;
         Eigen::Matrix<Float, Derived::SizeAtCompileTime, Derived::SizeAtCompileTime> hess(x.size(), x.size());
 
-        changeEval([&](const auto& x, int i, double){ fxi(i) = this->f(x); }, x, h);
+        execution(f, x, [&](int){ return -h; }, [&](int i, Float fy, Float){ fxi(i) = fy; });
 
-        changeEval([&](const auto& x, int i, double)
+        for(int i = 0; i < x.size(); ++i)
         {
-            changeEval([&](const auto& y, int j, double)
-            {
-                hess(i, j) = hess(j, i) = (fx - fxi(i) - fxi(j) + this->f(y)) / h2;
-
-            }, x, h, handy::range(i, x.size()));
-        }, x, h);
-
-        return hess;
-    }
+            y(i) = x(i) - h;
 
-    template <class Derived>
-    auto hessian (const Eigen::MatrixBase<Derived>& x, const Eigen::MatrixBase<Derived>& fx)
-    {
-        step.init(x);
+            execution(f, y, [&](int){ return -h; }, [&](int j, Float fy, Float)
+            {
+                hess(i, j) = hess(j, i) = (fx - fxi(i) - fxi(j) + fy) / h2;
 
-        Eigen::Matrix<typename Derived::Scalar, Derived::SizeAtCompileTime, Derived::SizeAtCompileTime> hess(x.size(), x.size());
+            }, i, x.size());
 
-        changeEval([&](const auto& x, int i, double h){ hess.col(i) = (this->f(x) - fx) / h; }, x, step);
+            y(i) = x(i);
+        }
 
         return hess;
     }
@@ -637,6 +684,20 @@ struct Backward : public FiniteDifference<Backward<Function, Step>>
     //@}
 
 
+    /// Jacobian of a vector function @c f at @c x, given @c fx = @c f(x)
+    template <class V, class U>
+    auto jacobian (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& fx)
+    {
+        using Float = impl::Scalar<V>;
+
+        Eigen::Matrix<Float, U::SizeAtCompileTime, V::SizeAtCompileTime> jac(fx.size(), x.size());
+
+        execution(f, x, [&](int i){ return -step(x, i); }, [&](int i, const auto& fy, Float h){ jac.col(i) = (fy - fx) / h; });
+
+        return jac;
+    }
+
+
     
     /** @brief Backward finite approximation of the gradient of @c f
      * 
@@ -673,7 +734,7 @@ struct Backward : public FiniteDifference<Backward<Function, Step>>
     template <class F, class Derived>
     static void changeEval (F f, const Eigen::MatrixBase<Derived>& x, typename Derived::Scalar inc)
     {
-        changeEval(f, x, [&](auto...){ return inc; });
+        changeEval(f, x, [&](auto&&...){ return inc; });
     }
 
     template <class F, class Derived, class StepSize, std::enable_if_t<!std::is_fundamental<StepSize>::value, int> = 0>
@@ -685,7 +746,7 @@ struct Backward : public FiniteDifference<Backward<Function, Step>>
     template <class F, class Derived, typename Int>
     static void changeEval (F f, const Eigen::MatrixBase<Derived>& x, typename Derived::Scalar inc, handy::Range<Int> range)
     {
-        changeEval(f, x, [&](auto...){ return inc; }, range);
+        changeEval(f, x, [&](auto&&...){ return inc; }, range);
     }
 
     template <class F, class Derived, class StepSize, typename Int, std::enable_if_t<!std::is_fundamental<StepSize>::value, int> = 0>
@@ -722,10 +783,10 @@ struct Backward : public FiniteDifference<Backward<Function, Step>>
  *  @tparam Step Step size template functor
  *  @tparam Float Base floating point type
 */
-template <class Function, class Step = AutoStep>
-struct Central : public FiniteDifference<Central<Function, Step>>
+template <class Function, class Step = AutoStep, class Execution = Sequential>
+struct Central : public FiniteDifference<Central<Function, Step, Execution>>
 {
-    CPPOPT_USING_FINITE_DIFFERENCE(Base, FiniteDifference<Central<Function, Step>>);
+    CPPOPT_USING_FINITE_DIFFERENCE(Base, FiniteDifference<Central<Function, Step, Execution>>);
 
     
     /** @name
@@ -744,13 +805,13 @@ struct Central : public FiniteDifference<Central<Function, Step>>
      *        gradient will have an overload without @c fx. The overload with @c fx will simply delegate the call 
     */
     //@{
-    template <typename Float>
+    template <typename Float, std::enable_if_t<std::is_floating_point<Float>::value, int> = 0>
     auto gradient (Float x)
     {
         return directional(x, 1.0);
     }
 
-    template <typename Float>
+    template <typename Float, std::enable_if_t<std::is_floating_point<Float>::value, int> = 0>
     auto gradient (Float x, Float)
     {
         return gradient(x);
@@ -784,22 +845,10 @@ struct Central : public FiniteDifference<Central<Function, Step>>
     void gradient (const Eigen::MatrixBase<Derived>& x, impl::Plain<Derived>& g)
     {
         step.init(x);
-        impl::Plain<Derived> y = x;
 
-        for(int i = 0; i < x.size(); ++i)
-        {
-            auto h = step(x, i);
-
-            y(i) = x(i) - h;
+        execution(f, x, [&](int i){ return -step(x, i); }, [&](int i, auto fl, auto){ g(i) = fl; });
 
-            auto fl = f(y);
-
-            y(i) = x(i) + h;
-
-            static_cast<impl::Plain<Derived>>(g)(i) = (f(y) - fl) / (2 * h);
-
-            y(i) = x(i);
-        }
+        execution(f, x, [&](int i){ return step(x, i); }, [&](int i, auto fr, auto h){ g(i) = (fr - g(i)) / (2 * h); });
     }
 
 
@@ -825,7 +874,7 @@ struct Central : public FiniteDifference<Central<Function, Step>>
      *  @param e The direction to calculate the hessian vector product @f$\nabla^2 f(x) e$@f.
     */
     //@{
-    template <typename Float>
+    template <typename Float, std::enable_if_t<std::is_floating_point<Float>::value, int> = 0>
     auto hessian (Float x, Float fx)
     {
         Float h = step(x);
@@ -925,21 +974,134 @@ struct Central : public FiniteDifference<Central<Function, Step>>
 };
 
 
+/** @brief Complex step difference class
+ * 
+ *  @details Evaluates @c f at @f$x + ihe_k@f$, so the derivative is @f$\frac{Im(f(x + ihe_k))}{h}@f$. There is no
+ *           subtraction, so there is no cancellation error and @c h can be as small as @f$10^{-20}@f$, giving
+ *           gradients accurate to machine precision with N function calls.
+ * 
+ *           The functor must be generic on the scalar type, returning @c std::complex when given a complex vector,
+ *           and must be analytic (no @c abs, comparisons or conjugates of the complex argument).
+ * 
+ *  @tparam Function Functor type
+ *  @tparam Step Step size template functor. With @c AutoStep, @f$h = 10^{-20}@f$ is used
+ *  @tparam Execution Execution policy of the gradient coordinates
+ * 
+ *  @note Only gradients and directional derivatives are provided
+*/
+template <class Function, class Step = AutoStep, class Execution = Sequential>
+struct ComplexStep : public FiniteDifference<ComplexStep<Function, Step, Execution>>
+{
+    CPPOPT_USING_FINITE_DIFFERENCE(Base, FiniteDifference<ComplexStep<Function, Step, Execution>>);
+
+
+    /** @name
+     *  @brief Gradient calculation with complex step
+     * 
+     *  @param x The Eigen::MatrixBase value where the gradient of @c f will be evaluated
+     *  @param fx Not needed, only kept for the same interface of the other differences
+     *  @param g A reference to where we will write the gradient of @c f calculated at @c x
+     * 
+     *  @note Unlike the base class, the overloads without @c fx do not evaluate @c f at @c x, taking only N calls
+    */
+    //@{
+    template <class Derived>
+    auto gradient (const Eigen::MatrixBase<Derived>& x)
+    {
+        impl::Plain<Derived> g(x.rows(), x.cols());
+
+        gradient(x, g);
+
+        return g;
+    }
+
+    template <class Derived>
+    auto gradient (const Eigen::MatrixBase<Derived>& x, typename Derived::Scalar)
+    {
+        return gradient(x);
+    }
+
+    template <class Derived>
+    void gradient (const Eigen::MatrixBase<Derived>& x, impl::Plain<Derived>& g, typename Derived::Scalar)
+    {
+        gradient(x, g);
+    }
+
+    template <class Derived>
+    void gradient (const Eigen::MatrixBase<Derived>& x, impl::Plain<Derived>& g)
+    {
+        using Complex = std::complex<impl::Scalar<Derived>>;
+
+        step.init(x);
+
+        Eigen::Matrix<Complex, Derived::RowsAtCompileTime, Derived::ColsAtCompileTime> xc = x.template cast<Complex>();
+
+        execution(f, xc, [&](int i){ return Complex(0, stepSize(step, x, i)); },
+                         [&](int i, auto fy, auto h){ g(i) = std::imag(fy) / std::imag(h); });
+    }
+    //@}
+
+
+    /** @name
+     *  @brief Directional derivative @f$\frac{Im(f(x + ihe))}{h}@f$
+    */
+    //@{
+    template <class Derived>
+    auto directional (const Eigen::MatrixBase<Derived>& x, const Eigen::MatrixBase<Derived>& e)
+    {
+        return directional(x, e, impl::Scalar<Derived>{}, stepSize(step, x));
+    }
+
+    template <class Derived>
+    auto directional (const Eigen::MatrixBase<Derived>& x, const Eigen::MatrixBase<Derived>& e, typename Derived::Scalar fx)
+    {
+        return directional(x, e, fx, stepSize(step, x));
+    }
+
+    template <class Derived>
+    auto directional (const Eigen::MatrixBase<Derived>& x, const Eigen::MatrixBase<Derived>& e, typename Derived::Scalar, typename Derived::Scalar h)
+    {
+        using Complex = std::complex<impl::Scalar<Derived>>;
+
+        return std::imag(f(x.template cast<Complex>() + Complex(0, h) * e.template cast<Complex>())) / h;
+    }
+    //@}
+
+
+    /// With @c AutoStep the step is @f$10^{-20}@f$, otherwise delegate to @c step
+    //@{
+    template <class Derived, typename... Args>
+    static impl::Scalar<Derived> stepSize (const AutoStep&, const Eigen::MatrixBase<Derived>&, const Args&...)
+    {
+        return impl::Scalar<Derived>(1e-20);
+    }
+
+    template <class S, class Derived, typename... Args>
+    static impl::Scalar<Derived> stepSize (const S& step, const Eigen::MatrixBase<Derived>& x, const Args&... args)
+    {
+        return step(x, args...);
+    }
+    //@}
+};
+
+
+
 /** @name
  *  @brief Classes used to join everything and expose interface via @c operator().
  *  
  *  @tparam Function The functor we are going to work with
  *  @tparam Difference The template describing which finite difference we will use
  *  @tparam Step The step size template
+ *  @tparam Execution The execution policy (@c Sequential or @c Parallel)
  *  @tparam Float Base floating point type
 */
 //@{
 
 /// Gradient interface for finite difference estimation
-template <class Function, template <class, class> class Difference, class Step>
-struct Gradient : public Difference<wrap::Function<Function>, Step>
+template <class Function, template <class, class, class> class Difference, class Step, class Execution>
+struct Gradient : public Difference<wrap::Function<Function>, Step, Execution>
 {
-    CPPOPT_USING_FINITE_DIFFERENCE(Base, Difference<wrap::Function<Function>, Step>);
+    CPPOPT_USING_FINITE_DIFFERENCE(Base, Difference<wrap::Function<Function>, Step, Execution>);
 
     
     /// Simply delegate the call to Difference<Function, Step, Float>::gradient
@@ -952,10 +1114,10 @@ struct Gradient : public Difference<wrap::Function<Function>, Step>
 
 
 /// Hessian interface for finite difference estimation
-template <class Function, template <class, class> class Difference = Forward, class Step = SimpleStep<>, typename Float = types::Float>
-struct Hessian : public Difference<wrap::Function<Function>, Step>
+template <class Function, template <class, class, class> class Difference = Forward, class Step = SimpleStep<>, typename Float = types::Float>
+struct Hessian : public Difference<wrap::Function<Function>, Step, Sequential>
 {
-    CPPOPT_USING_FINITE_DIFFERENCE(Base, Difference<wrap::Function<Function>, Step>);
+    CPPOPT_USING_FINITE_DIFFERENCE(Base, Difference<wrap::Function<Function>, Step, Sequential>);
 
     /** @name
      *  @brief Default constructor must have @c h equal to @f$u^{\frac{3}{4}}$@f
@@ -980,6 +1142,90 @@ struct Hessian : public Difference<wrap::Function<Function>, Step>
     //     return hessian(x);
     // }
 };
+
+
+/// The gradient of @c Gradient as a vector function. It only takes a single point, so it is never used as a batch function
+template <class Gradient>
+struct GradientFunction
+{
+    template <class V, std::enable_if_t<V::ColsAtCompileTime == 1, int> = 0>
+    impl::Plain<V> operator () (const Eigen::MatrixBase<V>& x)
+    {
+        return g.gradient(x);
+    }
+
+    wrap::Gradient<Gradient> g;
+};
+
+/** @brief Hessian interface for finite differences of an exact gradient
+ * 
+ *  @details The hessian is the jacobian of the gradient, costing N+1 gradient calls instead of the @f$O(N^2)@f$
+ *           function calls of Hessian. The result is symmetrized.
+ * 
+ *  @tparam Gradient A gradient functor or a function/gradient wrapper
+ *  @tparam Difference Either Forward or Backward
+*/
+template <class Gradient, template <class, class, class> class Difference = Forward, class Step = SimpleStep<>, class Execution = Sequential>
+struct GradientHessian : public Difference<GradientFunction<Gradient>, Step, Execution>
+{
+    using Base = Difference<GradientFunction<Gradient>, Step, Execution>;
+    using Base::jacobian;
+    using Base::f;
+    using Base::step;
+
+
+    GradientHessian (const Gradient& g, const Step& step = Step{}, const Execution& execution = Execution{}) :
+                     Base(GradientFunction<Gradient>{g}, step, execution) {}
+
+
+    /** @brief Symmetrized jacobian of the gradient
+     *  @param x The point where we evaluate the hessian
+     *  @param gx The gradient at @c x, if already known
+    */
+    //@{
+    template <class V>
+    auto hessian (const Eigen::MatrixBase<V>& x)
+    {
+        return hessian(x, f(x));
+    }
+
+    template <class V, class U>
+    auto hessian (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& gx)
+    {
+        auto jac = jacobian(x, gx);
+
+        return decltype(jac)((jac + jac.transpose()) / 2);
+    }
+    //@}
+
+    /** @brief Hessian vector product @f$\nabla^2 f(x) e@f$ from a single gradient call
+     *
+     *  @details The step is scaled by @f$(1 + \|x\|) / \|e\|@f$, so it does not depend on the size of the direction.
+     *
+     *  @param x The point where we evaluate the product
+     *  @param e The direction to be multiplied by the hessian
+     *  @param gx The gradient at @c x
+    */
+    template <class V, class U, class W>
+    impl::Plain<V> hessian (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& e, const Eigen::MatrixBase<W>& gx)
+    {
+        auto eNorm = e.norm();
+
+        if(eNorm == 0.0)
+            return impl::Plain<V>::Zero(x.rows(), x.cols());
+
+        auto h = step(x) * (1.0 + x.norm()) / eNorm;
+
+        return (f(x + h * e) - gx) / h;
+    }
+
+
+    template <typename... Args>
+    auto operator () (const Args&... args)
+    {
+        return hessian(args...);
+    }
+};
 //@}
 
 
@@ -1000,14 +1246,16 @@ struct Hessian : public Difference<wrap::Function<Function>, Step>
 */
 struct AutoStep
 {
-    AutoStep (...)
+    template <typename... Args>
+    AutoStep (const Args&...)
     {}
 
-    void init (...)
+    template <typename... Args>
+    void init (const Args&...)
     {}
 
-    template <class Derived>
-    impl::Scalar<Derived> operator () (const Eigen::MatrixBase<Derived>&, ...)  const
+    template <class Derived, typename... Args>
+    impl::Scalar<Derived> operator () (const Eigen::MatrixBase<Derived>&, const Args&...)  const
     {
         return constants::eps_<impl::Scalar<Derived>>;
     }
@@ -1019,10 +1267,12 @@ struct SimpleStep
 {
     SimpleStep (Float h = constants::eps_<Float>) : h(h) {}
 
-    void init (...)
+    template <typename... Args>
+    void init (const Args&...)
     {}
 
-    Float operator () (...) const
+    template <typename... Args>
+    Float operator () (const Args&...) const
     {
         return h;
     }
@@ -1054,6 +1304,129 @@ struct NormalizedStep : public SimpleStep<Float>
 //@}
 
 
+
+/** @name
+ *  @brief Execution policies for the coordinate evaluations of the finite differences
+ *
+ *  @details Given the functor @c f, the point @c x, an increment functor @c inc and a @c result callback, the policy
+ *           evaluates @f$f(x + inc(i) e_i)@f$ for every coordinate @c i in <tt>begin, ..., end-1</tt> (all of them by
+ *           default), calling <tt>result(i, fi, inc(i))</tt> with each value. When @c f is a batch function, the
+ *           perturbed points are given to it in blocks of at most @c batchSize columns.
+*/
+//@{
+
+/// Common evaluation of a range of coordinates, by single point or batch calls
+struct ExecutionBase
+{
+    ExecutionBase (int batchSize = 64) : batchSize(std::max(batchSize, 1)) {}
+
+
+    template <class Function, class V, class Increment, class Result, std::enable_if_t<!wrap::IsBatchFunction<Function, impl::Plain<V>>::value, int> = 0>
+    void evaluate (Function& f, const Eigen::MatrixBase<V>& x, Increment& inc, Result& result, int begin, int end) const
+    {
+        impl::Plain<V> y = x;
+
+        for(int i = begin; i < end; ++i)
+        {
+            auto h = inc(i);
+
+            y(i) = x(i) + h;
+
+            result(i, f(y), h);
+
+            y(i) = x(i);
+        }
+    }
+
+    template <class Function, class V, class Increment, class Result, std::enable_if_t<wrap::IsBatchFunction<Function, impl::Plain<V>>::value, int> = 0>
+    void evaluate (Function& f, const Eigen::MatrixBase<V>& x, Increment& inc, Result& result, int begin, int end) const
+    {
+        int K = std::min(batchSize, end - begin);
+
+        if(K <= 0)
+            return;
+
+        Eigen::Matrix<impl::Scalar<V>, V::RowsAtCompileTime, Eigen::Dynamic> Y = x.replicate(1, K);
+        Eigen::Matrix<impl::Scalar<V>, Eigen::Dynamic, 1> hs(K);
+
+        for(int b = begin; b < end; b += K)
+        {
+            int k = std::min(K, end - b);
+
+            for(int j = 0; j < k; ++j)
+                hs(j) = inc(b + j), Y(b + j, j) = x(b + j) + hs(j);
+
+            auto fy = f.batchFunction(Y.leftCols(k));
+
+            for(int j = 0; j < k; ++j)
+                result(b + j, fy(j), hs(j)), Y(b + j, j) = x(b + j);
+        }
+    }
+
+
+    int batchSize;      ///< Maximum number of points given at once to a batch function
+};
+
+
+/// Evaluate every coordinate in order, in the calling thread
+struct Sequential : public ExecutionBase
+{
+    using ExecutionBase::ExecutionBase;
+
+    template <class Function, class V, class Increment, class Result>
+    void operator () (Function& f, const Eigen::MatrixBase<V>& x, Increment inc, Result result) const
+    {
+        (*this)(f, x, inc, result, 0, x.size());
+    }
+
+    template <class Function, class V, class Increment, class Result>
+    void operator () (Function& f, const Eigen::MatrixBase<V>& x, Increment inc, Result result, int begin, int end) const
+    {
+        evaluate(f, x, inc, result, begin, end);
+    }
+};
+
+
+/** @brief Split the coordinates in contiguous blocks evaluated by a thread pool
+ *
+ *  @details Each block gets its own copy of @c f and @c x, so the functor must be copyable and each copy must be
+ *           safe to call concurrently with the others. Copies of this class share the same pool.
+*/
+struct Parallel : public ExecutionBase
+{
+    Parallel (int numThreads = std::thread::hardware_concurrency(), int batchSize = 64) :
+              ExecutionBase(batchSize), pool(std::make_shared<impl::ThreadPool>(numThreads))
+    {
+    }
+
+    template <class Function, class V, class Increment, class Result>
+    void operator () (Function& f, const Eigen::MatrixBase<V>& x, Increment inc, Result result) const
+    {
+        (*this)(f, x, inc, result, 0, x.size());
+    }
+
+    template <class Function, class V, class Increment, class Result>
+    void operator () (Function& f, const Eigen::MatrixBase<V>& x, Increment inc, Result result, int begin, int end) const
+    {
+        int N = end - begin;
+        int numBlocks = std::min(N, pool->size());
+
+        if(numBlocks <= 1)
+            return evaluate(f, x, inc, result, begin, end);
+
+        pool->run(numBlocks, [&](int block)
+        {
+            Function fb = f;
+
+            evaluate(fb, x, inc, result, begin + (block * N) / numBlocks, begin + ((block + 1) * N) / numBlocks);
+        });
+    }
+
+    std::shared_ptr<impl::ThreadPool> pool;
+};
+//@}
+
+
 /** @name
  *  @brief Simple functions used to delegate the call to the given classes
  * 
@@ -1063,30 +1436,78 @@ struct NormalizedStep : public SimpleStep<Float>
  *  @tparam Float Base floating point type
 */
 //@{
-template <class Function, template <class, class> class Difference = Forward, class Step = AutoStep>
+template <class Function, template <class, class, class> class Difference = Forward, class Step = AutoStep>
 auto gradient (const Function& f)
 {
     return Gradient<Function, Difference, Step>(f);
 }
 
-template <class Function, template <class, class> class Difference = Forward, class Step = AutoStep>
+template <class Function, template <class, class, class> class Difference = Forward, class Step = AutoStep>
 auto gradient (const Function& f, const Step& step)
 {
     return Gradient<Function, Difference, Step>(f, step);
 }
 
+template <class Function, template <class, class, class> class Difference = Forward, class Step = AutoStep>
+auto gradient (const Function& f, const Parallel& parallel)
+{
+    return Gradient<Function, Difference, Step, Parallel>(f, Step{}, parallel);
+}
+
+template <class Function, template <class, class, class> class Difference = Forward, class Step = AutoStep, class Execution>
+auto gradient (const Function& f, const Step& step, const Execution& execution)
+{
+    return Gradient<Function, Difference, Step, Execution>(f, step, execution);
+}
 
-template <class Function, template <class, class> class Difference = Forward, class Step = SimpleStep<>>
+
+template <class Function, template <class, class, class> class Difference = Forward, class Step = SimpleStep<>,
+          std::enable_if_t<!wrap::HasExactGradient<Function>::value, int> = 0>
 auto hessian (const Function& f)
 {
     return Hessian<Function, Difference, Step>(f);
 }
 
-template <class Function, template <class, class> class Difference = Forward, class Step = AutoStep>
+template <class Function, template <class, class, class> class Difference = Forward, class Step = AutoStep,
+          std::enable_if_t<!wrap::HasExactGradient<Function>::value, int> = 0>
 auto hessian (const Function& f, const Step& step)
 {
     return Hessian<Function, Difference, Step>(f, step);
 }
+
+/// If @c f is a function/gradient wrapper with an exact gradient, use N+1 gradient calls instead
+template <class Function, template <class, class, class> class Difference = Forward, class Step = SimpleStep<>,
+          std::enable_if_t<wrap::HasExactGradient<Function>::value, int> = 0>
+auto hessian (const Function& f)
+{
+    return GradientHessian<Function, Difference, Step>(f);
+}
+
+template <class Function, template <class, class, class> class Difference = Forward, class Step = AutoStep,
+          std::enable_if_t<wrap::HasExactGradient<Function>::value, int> = 0>
+auto hessian (const Function& f, const Step& step)
+{
+    return GradientHessian<Function, Difference, Step>(f, step);
+}
+
+
+template <class Gradient, template <class, class, class> class Difference = Forward, class Step = SimpleStep<>>
+auto gradientHessian (const Gradient& g)
+{
+    return GradientHessian<Gradient, Difference, Step>(g);
+}
+
+template <class Gradient, template <class, class, class> class Difference = Forward, class Step = SimpleStep<>>
+auto gradientHessian (const Gradient& g, const Parallel& parallel)
+{
+    return GradientHessian<Gradient, Difference, Step, Parallel>(g, Step{}, parallel);
+}
+
+template <class Gradient, template <class, class, class> class Difference = Forward, class Step = SimpleStep<>, class Execution>
+auto gradientHessian (const Gradient& g, const Step& step, const Execution& execution)
+{
+    return GradientHessian<Gradient, Difference, Step, Execution>(g, step, execution);
+}
 //@}
 
 //@}
@@ -95,15 +95,45 @@ struct AutoStep;
 template <typename Float = types::Float>
 struct SimpleStep;
 
-template <class Function, class Step = AutoStep>
+struct Sequential;
+
+struct Parallel;
+
+template <class Function, class Step = AutoStep, class Execution = Sequential>
 struct Forward;
 
-template <class Function, template <class, class> class Difference = Forward, class Step = AutoStep>
+template <class Function, template <class, class, class> class Difference = Forward, class Step = AutoStep, class Execution = Sequential>
 struct Gradient;
 
 } // namespace fd
 
 
+namespace ad
+{
+
+template <typename Float, int Lanes>
+struct Dual;
+
+template <class Function, int Lanes = 8>
+struct Gradient;
+
+template <class Function, typename Float = types::Float>
+struct Reverse;
+
+template <class T, class V = Vec>
+struct IsDifferentiable;
+
+/** @brief Tag of the functors opting in to automatic differentiation
+ * 
+ *  @details A function-only functor deriving from it is differentiated with ad::Gradient when wrapped, if it can also be
+ *           called with a vector of duals. Without the tag, its gradient is a finite difference, so a generic functor calling
+ *           @c std::sin or @c std::pow (which have no dual overloads) is never instantiated with duals.
+*/
+struct Differentiable {};
+
+} // namespace ad
+
+
 namespace wrap
 {
 
@@ -119,12 +149,21 @@ struct Gradient;
 template <class...>
 struct FunctionGradient;
 
+template <class Impl, class V = Vec>
+struct Cache;
+
 } // namespace impl
 
 
 template <class T, class V = Vec>
 struct FunctionType;
 
+template <class T, class V = Vec>
+struct BatchFunctionType;
+
+template <class T, class V = Vec>
+struct IsBatchFunction;
+
 template <class T, class V = Vec>
 struct GradientType;
 
@@ -141,29 +180,54 @@ using Function = std::conditional_t<handy::IsSpecialization<Impl, impl::Function
 template <class Impl>
 using Gradient = std::conditional_t<handy::IsSpecialization<Impl, impl::Gradient>::value, Impl, impl::Gradient<Impl>>;
 
+/// Whether @c Func is a function (or batch function) but not a function/gradient functor, so its gradient must be provided
+template <class Func>
+using IsFunctionOnly = std::conjunction<std::bool_constant<(wrap::FunctionGradientType<Func>::value < 0)>,
+                                        std::disjunction<std::bool_constant<(wrap::FunctionType<Func>::value >= 0)>, wrap::IsBatchFunction<Func>>>;
+
 /** @brief Alias for impl::FunctionGradient
  *  @details There are four conditions:
  *           - Is @c Grad given?
- *              - If not, is @c Func already an impl::FunctionGradient?
+ *              - If not, is @c Func already an impl::FunctionGradient (or an impl::Cache)?
  *                  - (1) If so, simply set the result to itself (to avoid multiple wrapping)
- *                  - Otherwise, is @c Func a function but not a function/gradient functor?
- *                      - (2) If so, set the result to impl::FunctionGradient<Func, fd::Gradient<Func>> (use finite difference to aproximate the gradient)
- *                      - (3) Otherwise it should be a function/gradient functor, so we use impl::FunctionGradient<Func>
- *              - (4) If yes, set the result to impl::FunctionGradient<Func, Grad>
+ *                  - Otherwise, is @c Func a function (or batch function) but not a function/gradient functor?
+ *                      - (2) If so and @c Func derives from ad::Differentiable and can be evaluated with dual numbers, set the result to
+ *                            impl::FunctionGradient<Func, ad::Gradient<Func>>
+ *                            (use forward automatic differentiation to calculate the gradient)
+ *                      - (3) If so but not differentiable, set the result to impl::FunctionGradient<Func, fd::Gradient<Func>> (use finite difference to aproximate the gradient)
+ *                      - (4) Otherwise it should be a function/gradient functor, so we use impl::FunctionGradient<Func>
+ *              - (5) If yes, set the result to impl::FunctionGradient<Func, Grad>
 */
 template <class Func, class Grad = void>
 using FunctionGradient = std::conditional_t<std::is_same<Grad, void>::value,
-    std::conditional_t<handy::IsSpecialization<Func, impl::FunctionGradient>::value,
+    std::conditional_t<std::disjunction<handy::IsSpecialization<Func, impl::FunctionGradient>, handy::IsSpecialization<Func, impl::Cache>>::value,
         Func,
-        std::conditional_t<wrap::FunctionType<Func>::value >= 0 && wrap::FunctionGradientType<Func>::value < 0,
-            impl::FunctionGradient<Func, fd::Gradient<Func>>,
-            impl::FunctionGradient<Func>
+        std::conditional_t<std::conjunction<IsFunctionOnly<Func>, ad::IsDifferentiable<Func>>::value,
+            impl::FunctionGradient<Func, ad::Gradient<Func>>,
+            std::conditional_t<IsFunctionOnly<Func>::value,
+                impl::FunctionGradient<Func, fd::Gradient<Func>>,
+                impl::FunctionGradient<Func>
+            >
         >
     >,
     impl::FunctionGradient<Func, Grad>
 >;
 
 
+/// Whether @c T is a function/gradient wrapper whose gradient is exact, that is, not a finite difference approximation
+template <class T>
+struct HasExactGradient : std::false_type {};
+
+template <class... Ts>
+struct HasExactGradient<impl::FunctionGradient<Ts...>> : std::true_type {};
+
+template <class Func, class Function, template <class, class, class> class Difference, class Step, class Execution>
+struct HasExactGradient<impl::FunctionGradient<Func, fd::Gradient<Function, Difference, Step, Execution>>> : std::false_type {};
+
+template <class Impl, class V>
+struct HasExactGradient<impl::Cache<Impl, V>> : HasExactGradient<Impl> {};
+
+
 } // namespace wrap
 
 
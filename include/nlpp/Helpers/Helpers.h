@@ -161,11 +161,27 @@ struct IsScalar
 	};
 };
 
+/// Tells if @c T is an Eigen::SparseMatrixBase
+template <typename T>
+struct IsSparse
+{
+	template <class U>
+	static constexpr bool impl (Eigen::SparseMatrixBase<U>*) { return true; }
+
+	static constexpr bool impl (...) { return false; }
+
+
+	enum { value = impl((std::decay_t<T>*)0) };
+};
+
 template <typename T>
 constexpr bool isMat = IsMat<T>::value;
 
 template <typename T>
 constexpr bool isScalar = IsScalar<T>::value;
+
+template <typename T>
+constexpr bool isSparse = IsSparse<T>::value;
 //@}
 
 
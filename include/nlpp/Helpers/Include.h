@@ -6,14 +6,17 @@
 #if EIGEN_INCLUDE_LOCAL
 
     #include "../external/Eigen/Eigen/Dense"
+    #include "../external/Eigen/Eigen/Sparse"
 
 #elif EIGEN_INCLUDE_LOCAL_RELEASE
 
     #include "Eigen/Dense"
+    #include "Eigen/Sparse"
 
 #elif EIGEN_INCLUDE_GLOBAL
 
     #include <eigen3/Eigen/Dense>
+    #include <eigen3/Eigen/Sparse>
 
 #endif
 
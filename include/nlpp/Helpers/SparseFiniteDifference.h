@@ -0,0 +1,415 @@
+/** @file
+
+    @brief Finite difference jacobians and hessians exploiting a known sparsity pattern
+
+    @details Columns that never have a nonzero on the same row can be perturbed together, so a single evaluation
+             gives all of them. The columns are grouped by a greedy coloring of the pattern:
+
+             - Curtis-Powell-Reid (@c cprColoring): columns sharing a row get different colors. Any jacobian
+               entry is read directly from the difference of its column group.
+             - Star coloring (@c starColoring): for symmetric patterns, a distance-1 coloring with no path of 4
+               vertices using only 2 colors. Each hessian entry @f$H_{ij}@f$ is read either from the group of @c j
+               or, by symmetry, from the group of @c i. It usually needs fewer colors than CPR.
+
+             For a banded matrix of bandwidth @c b, the number of colors is @c O(b) instead of @c N. So a hessian
+             from gradient differences costs @c O(b) gradient calls, and a hessian from function values costs
+             @c O(nnz) function calls, instead of @c O(N) and @c O(N^2).
+
+             The pattern is an @c Eigen::SparseMatrix whose structure (not values) gives the possible nonzeros. It can
+             be given by the user or detected with @c hessianPattern, at the cost of a single dense hessian.
+**/
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "FiniteDifference.h"
+
+
+namespace nlpp
+{
+
+namespace fd
+{
+
+/** @name
+ *  @brief Greedy colorings of the columns of a sparsity pattern
+ *
+ *  @param pattern Column major sparse matrix. For @c starColoring it must be symmetric
+ *  @returns The color of each column, from @c 0 to the number of colors minus one
+*/
+//@{
+template <typename Float>
+std::vector<int> cprColoring (const Eigen::SparseMatrix<Float>& pattern)
+{
+    Eigen::SparseMatrix<Float, Eigen::RowMajor> rows = pattern;
+
+    std::vector<int> colors(pattern.cols(), -1), forbidden(pattern.cols() + 1, -1);
+
+    for(int j = 0; j < pattern.cols(); ++j)
+    {
+        for(typename Eigen::SparseMatrix<Float>::InnerIterator it(pattern, j); it; ++it)
+            for(typename Eigen::SparseMatrix<Float, Eigen::RowMajor>::InnerIterator jt(rows, it.row()); jt; ++jt)
+                if(colors[jt.col()] >= 0)
+                    forbidden[colors[jt.col()]] = j;
+
+        int c = 0;
+
+        while(forbidden[c] == j)
+            ++c;
+
+        colors[j] = c;
+    }
+
+    return colors;
+}
+
+template <typename Float>
+std::vector<int> starColoring (const Eigen::SparseMatrix<Float>& pattern)
+{
+    using Iterator = typename Eigen::SparseMatrix<Float>::InnerIterator;
+
+    std::vector<int> colors(pattern.cols(), -1), forbidden(pattern.cols() + 1, -1);
+
+    for(int v = 0; v < pattern.cols(); ++v)
+    {
+        for(Iterator w(pattern, v); w; ++w)
+        {
+            if(w.row() == v)
+                continue;
+
+            if(colors[w.row()] >= 0)
+                forbidden[colors[w.row()]] = v;
+
+            for(Iterator x(pattern, w.row()); x; ++x)
+            {
+                if(x.row() == v || x.row() == w.row() || colors[x.row()] < 0)
+                    continue;
+
+                if(colors[w.row()] < 0)
+                    forbidden[colors[x.row()]] = v;
+
+                else
+                {
+                    for(Iterator y(pattern, x.row()); y; ++y)
+                    {
+                        if(y.row() != w.row() && y.row() != x.row() && colors[y.row()] == colors[w.row()])
+                        {
+                            forbidden[colors[x.row()]] = v;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        int c = 0;
+
+        while(forbidden[c] == v)
+            ++c;
+
+        colors[v] = c;
+    }
+
+    return colors;
+}
+//@}
+
+
+/** @brief Sparse jacobian of a vector function by compressed forward differences
+ *
+ *  @details Each color group costs a single call to @c f. If @c symmetric is set, the pattern must be symmetric and
+ *           the jacobian is assumed to be symmetric as well (a hessian from gradient differences), using the star
+ *           coloring. Otherwise, or if the star coloring cannot recover some entry, the CPR coloring is used.
+ *
+ *  @tparam Function Functor returning a vector for a given vector (such as a gradient functor)
+ *  @tparam Float Base floating point type
+*/
+template <class Function, typename Float = types::Float>
+struct SparseJacobian
+{
+    using Sparse = Eigen::SparseMatrix<Float>;
+
+
+    SparseJacobian (const Function& f, const Sparse& pattern, bool symmetric = false, Float h = constants::eps_<Float>) :
+                    f(f), jac(pattern), h(h)
+    {
+        jac.makeCompressed();
+
+        /// If the greedy star coloring leaves an entry with no isolated source, the CPR coloring recovers all of them
+        if(!(symmetric && color(starColoring(jac), true)))
+            color(cprColoring(jac), false);
+    }
+
+
+    /** @brief Groups the columns by @c newColors and finds the source of each nonzero
+     *  @returns Whether every nonzero can be recovered. Always true if @c symmetric is not set
+    */
+    bool color (const std::vector<int>& newColors, bool symmetric)
+    {
+        colors = newColors;
+
+        numColors = colors.empty() ? 0 : *std::max_element(colors.begin(), colors.end()) + 1;
+
+        groups.assign(numColors, {});
+
+        for(int j = 0; j < jac.cols(); ++j)
+            groups[colors[j]].push_back(j);
+
+        /// For each nonzero, the position (row, color) of the compressed differences where its value lies
+        sources.clear();
+        sources.reserve(jac.nonZeros());
+
+        for(int j = 0; j < jac.cols(); ++j)
+        {
+            for(typename Sparse::InnerIterator it(jac, j); it; ++it)
+            {
+                int i = it.row();
+
+                if(!symmetric || isolated(i, colors[j]))
+                    sources.emplace_back(i, colors[j]);
+
+                else if(isolated(j, colors[i]))
+                    sources.emplace_back(j, colors[i]);
+
+                else
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    /** @brief Jacobian at @c x
+     *  @param x The point where we evaluate the jacobian
+     *  @param fx The value of @c f(x), if already known
+    */
+    //@{
+    template <class V>
+    Sparse jacobian (const Eigen::MatrixBase<V>& x)
+    {
+        return jacobian(x, f(x));
+    }
+
+    template <class V, class U>
+    Sparse jacobian (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& fx)
+    {
+        impl::Plain<V> y = x;
+        Eigen::Matrix<Float, Eigen::Dynamic, Eigen::Dynamic> diffs(fx.size(), numColors);
+
+        for(int c = 0; c < numColors; ++c)
+        {
+            for(int j : groups[c])
+                y(j) = x(j) + h;
+
+            diffs.col(c) = (f(y) - fx) / h;
+
+            for(int j : groups[c])
+                y(j) = x(j);
+        }
+
+        Float* values = jac.valuePtr();
+
+        for(std::size_t k = 0; k < sources.size(); ++k)
+            values[k] = diffs(sources[k].first, sources[k].second);
+
+        return jac;
+    }
+    //@}
+
+
+    template <class... Args>
+    Sparse operator () (const Args&... args)
+    {
+        return jacobian(args...);
+    }
+
+
+    /// Whether @c j is the only nonzero column of row @c i having color @c c
+    bool isolated (int i, int c) const
+    {
+        int count = 0;
+
+        for(typename Sparse::InnerIterator it(jac, i); it; ++it)
+            count += colors[it.row()] == c;
+
+        return count == 1;
+    }
+
+
+    Function f;                                 ///< Functor variable
+
+    Sparse jac;                                 ///< Pattern, overwritten with the last jacobian
+
+    Float h;                                    ///< Step size
+
+    std::vector<int> colors;                    ///< Color of each column
+
+    int numColors;                              ///< Number of column groups (function calls per jacobian)
+
+    std::vector<std::vector<int>> groups;       ///< Columns of each color
+
+    std::vector<std::pair<int, int>> sources;   ///< Compressed position of each nonzero
+};
+
+
+/** @brief Sparse hessian of a scalar function, using only function values
+ *
+ *  @details With the CPR coloring, each row @c i has at most one nonzero @f$H_{ij}@f$ in the column group @c d
+ *           of a color, so:
+ *
+ *           @f$H_{ij} \approx \frac{f(x + hd + he_i) - f(x + hd) - f(x + he_i) + f(x)}{h^2}@f$
+ *
+ *           The total cost is @f$N + 1 + \sum_c (1 + r_c)@f$ function calls, where @f$r_c@f$ is the number of rows
+ *           with a nonzero in the group @c c, that is, @c O(nnz) instead of @f$O(N^2)@f$.
+ *
+ *  @tparam Function Scalar function functor
+ *  @tparam Float Base floating point type
+*/
+template <class Function, typename Float = types::Float>
+struct SparseHessian
+{
+    using Sparse = Eigen::SparseMatrix<Float>;
+
+
+    SparseHessian (const Function& f, const Sparse& pattern, Float h = std::pow(constants::eps_<Float>, 0.5)) :
+                   f(f), hess(pattern), h(h)
+    {
+        hess.makeCompressed();
+
+        colors = cprColoring(hess);
+
+        int numColors = colors.empty() ? 0 : *std::max_element(colors.begin(), colors.end()) + 1;
+
+        /// For each color, the rows having a nonzero in the group and the position of this nonzero
+        rows.resize(numColors);
+
+        for(int j = 0; j < hess.cols(); ++j)
+            for(typename Sparse::InnerIterator it(hess, j); it; ++it)
+                rows[colors[j]].emplace_back(it.row(), &it.valueRef() - hess.valuePtr());
+    }
+
+
+    template <class V>
+    Sparse hessian (const Eigen::MatrixBase<V>& x)
+    {
+        return hessian(x, f(x));
+    }
+
+    template <class V>
+    Sparse hessian (const Eigen::MatrixBase<V>& x, Float fx)
+    {
+        impl::Plain<V> y = x, fxi(x.rows(), x.cols());
+
+        Sequential{}(f, x, [&](int){ return h; }, [&](int i, Float fy, Float){ fxi(i) = fy; });
+
+        Float* values = hess.valuePtr();
+
+        for(std::size_t c = 0; c < rows.size(); ++c)
+        {
+            for(int j = 0; j < x.size(); ++j)
+                if(colors[j] == int(c))
+                    y(j) = x(j) + h;
+
+            Float fc = f(y);
+
+            for(auto [i, k] : rows[c])
+            {
+                Float yi = y(i);
+
+                y(i) = yi + h;
+
+                values[k] = (f(y) - fc - fxi(i) + fx) / (h * h);
+
+                y(i) = yi;
+            }
+
+            y = x;
+        }
+
+        return hess;
+    }
+
+
+    template <class V>
+    Sparse operator () (const Eigen::MatrixBase<V>& x)
+    {
+        return hessian(x);
+    }
+
+
+    wrap::Function<Function> f;                         ///< Functor variable
+
+    Sparse hess;                                        ///< Pattern, overwritten with the last hessian
+
+    Float h;                                            ///< Step size
+
+    std::vector<int> colors;                            ///< Color of each column
+
+    std::vector<std::vector<std::pair<int, int>>> rows; ///< Row and value index of the nonzeros of each group
+};
+
+
+/** @brief Detect the sparsity pattern of the hessian of @c f at @c x
+ *
+ *  @details Uses a single dense finite difference hessian, so it costs @f$O(N^2)@f$ calls. Entries with absolute
+ *           value up to @c tol times the largest absolute entry are taken as finite difference noise and discarded.
+ *           The diagonal is always kept and the pattern is symmetric.
+ *
+ *  @note Choose a generic point @c x. Entries that vanish by chance at @c x are lost
+*/
+template <class Function, class V>
+auto hessianPattern (const Function& f, const Eigen::MatrixBase<V>& x,
+                     impl::Scalar<V> tol = std::sqrt(constants::eps_<impl::Scalar<V>>))
+{
+    using Float = impl::Scalar<V>;
+
+    auto dense = hessian(f)(x.eval());
+
+    tol *= dense.cwiseAbs().maxCoeff();
+
+    std::vector<Eigen::Triplet<Float>> triplets;
+
+    for(int j = 0; j < dense.cols(); ++j)
+        for(int i = 0; i < dense.rows(); ++i)
+            if(i == j || std::abs(dense(i, j)) > tol || std::abs(dense(j, i)) > tol)
+                triplets.emplace_back(i, j, Float(1));
+
+    Eigen::SparseMatrix<Float> pattern(dense.rows(), dense.cols());
+
+    pattern.setFromTriplets(triplets.begin(), triplets.end());
+
+    return pattern;
+}
+
+
+/** @name
+ *  @brief Simple functions used to delegate the call to the given classes
+*/
+//@{
+template <class Function, typename Float>
+auto sparseJacobian (const Function& f, const Eigen::SparseMatrix<Float>& pattern)
+{
+    return SparseJacobian<Function, Float>(f, pattern);
+}
+
+/// Hessian from function values only
+template <class Function, typename Float>
+auto sparseHessian (const Function& f, const Eigen::SparseMatrix<Float>& pattern)
+{
+    return SparseHessian<Function, Float>(f, pattern);
+}
+
+/// Hessian as the symmetric jacobian of the gradient @c g
+template <class Gradient, typename Float>
+auto sparseGradientHessian (const Gradient& g, const Eigen::SparseMatrix<Float>& pattern)
+{
+    return SparseJacobian<wrap::Gradient<Gradient>, Float>(wrap::gradient(g), pattern, true);
+}
+//@}
+
+} // namespace fd
+
+} // namespace nlpp
@@ -0,0 +1,144 @@
+/** @file
+ *  @brief A minimal blocking thread pool, used to run independent function evaluations concurrently
+*/
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <vector>
+
+#include "Helpers.h"
+
+
+namespace nlpp
+{
+
+namespace impl
+{
+
+/** @brief Fixed size thread pool exposing a single blocking parallel-for
+ *
+ *  @details The threads are created once and sleep between calls to @c run. The calling thread also takes part
+ *           in the work, so a pool of size @c N creates only @c N-1 threads. Calls to @c run from different
+ *           threads are serialized.
+*/
+struct ThreadPool
+{
+    ThreadPool (int numThreads = std::thread::hardware_concurrency()) : numThreads(std::max(numThreads, 1))
+    {
+        for(int i = 0; i < this->numThreads - 1; ++i)
+            workers.emplace_back([this]{ loop(); });
+    }
+
+    ThreadPool (const ThreadPool&) = delete;
+    ThreadPool& operator= (const ThreadPool&) = delete;
+
+    ~ThreadPool ()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finish = true;
+        }
+
+        wake.notify_all();
+
+        for(auto& worker : workers)
+            worker.join();
+    }
+
+
+    /** @brief Call @c task(t) for every @c t in <tt>0, ..., numTasks-1</tt>, returning only when all of them are done
+     *  @note If any task throws, the first exception is rethrown here, after all tasks have finished
+    */
+    template <class Task>
+    void run (int numTasks, Task task)
+    {
+        std::lock_guard<std::mutex> runLock(runMutex);
+        std::unique_lock<std::mutex> lock(mutex);
+
+        job = std::ref(task);
+        next = 0;
+        pending = tasks = numTasks;
+        failure = nullptr;
+
+        wake.notify_all();
+
+        while(next < tasks)
+            execute(lock);
+
+        done.wait(lock, [&]{ return pending == 0; });
+
+        tasks = 0;
+        job = nullptr;
+
+        if(failure)
+            std::rethrow_exception(failure);
+    }
+
+    int size () const { return numThreads; }
+
+
+private:
+
+    void loop ()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while(true)
+        {
+            wake.wait(lock, [&]{ return finish || next < tasks; });
+
+            if(finish)
+                return;
+
+            execute(lock);
+        }
+    }
+
+    /// Take the next task and run it with the lock released
+    void execute (std::unique_lock<std::mutex>& lock)
+    {
+        int t = next++;
+
+        lock.unlock();
+
+        std::exception_ptr error;
+
+        try { job(t); }
+        catch(...) { error = std::current_exception(); }
+
+        lock.lock();
+
+        if(error && !failure)
+            failure = error;
+
+        if(--pending == 0)
+            done.notify_all();
+    }
+
+
+    int numThreads;
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::mutex runMutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    std::function<void(int)> job;
+    std::exception_ptr failure;
+
+    int tasks = 0;
+    int next = 0;
+    int pending = 0;
+    bool finish = false;
+};
+
+} // namespace impl
+
+} // namespace nlpp
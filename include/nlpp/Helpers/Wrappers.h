@@ -13,14 +13,23 @@
  *           FunctionGradient can also provide an interface for calculating function and gradients separatelly:
  *          
  *           @snippet Helpers/Gradient.cpp FunctionGradient snippet
+ * 
+ *           A function/gradient wrapper can also be memoized with @c wrap::cache, so repeated evaluations of the same
+ *           point (by the line search and the optimizer, for example) are not given to the functor again.
 */
 
 #pragma once
 
+#include <vector>
+#include <memory>
+#include <cstring>
+
 #include "Helpers.h"
 
 #include "FiniteDifference.h"
 
+#include "AutoDiff.h"
+
 
 namespace nlpp
 {
@@ -43,16 +52,19 @@ namespace wrap
 */
 //@{
  
-/// Check if class T is a function functor
+/// Check if class T is a function functor, returning either a floating point or the scalar type of @c V (such as @c std::complex)
 template <class T, class V>
 struct FunctionType
 {
+    template <class R>
+    static constexpr bool isScalar = std::is_floating_point<R>::value || std::is_same<std::decay_t<R>, ::nlpp::impl::Scalar<V>>::value;
+
     /// If T has an function member `Float function(V)`
-    template <class U = T, std::enable_if_t<std::is_floating_point<decltype(std::declval<U>().function(std::declval<V>()))>::value, int> = 0>
+    template <class U = T, std::enable_if_t<isScalar<decltype(std::declval<U>().function(std::declval<V>()))>, int> = 0>
     static constexpr int impl (::nlpp::impl::Precedence<0>) { return 0; }
 
     /// If T has an function member `Float operator()(V)`
-    template <class U = T, std::enable_if_t<std::is_floating_point<decltype(std::declval<U>().operator()(std::declval<V>()))>::value, int> = 0>
+    template <class U = T, std::enable_if_t<isScalar<decltype(std::declval<U>().operator()(std::declval<V>()))>, int> = 0>
     static constexpr int impl (::nlpp::impl::Precedence<1>) { return 1; }
 
     /// Otherwise return false
@@ -66,6 +78,56 @@ template <class T, class V>
 struct IsFunction : std::integral_constant<bool, (FunctionType<T, V>::value)> {};
 
 
+/** @brief Check if class T is a batch function functor, evaluating every column of a matrix of points at once
+ * 
+ *  @details The functor takes a @c N x @c K matrix, where each column is a point, and returns an Eigen vector with
+ *           the @c K function values. If @c T has a deduced return type, it is instantiated with a matrix argument.
+*/
+template <class T, class V>
+struct BatchFunctionType
+{
+    using M = Eigen::Matrix<::nlpp::impl::Scalar<V>, V::RowsAtCompileTime, Eigen::Dynamic>;
+
+    /// If T has an function member `Eigen::EigenBase<W> function(M)`
+    template <class U = T, std::enable_if_t<::nlpp::impl::isMat<decltype(std::declval<U>().function(std::declval<M>()))>, int> = 0>
+    static constexpr int impl (::nlpp::impl::Precedence<0>) { return 0; }
+
+    /// If T has an function member `Eigen::EigenBase<W> operator()(M)`
+    template <class U = T, std::enable_if_t<::nlpp::impl::isMat<decltype(std::declval<U>().operator()(std::declval<M>()))>, int> = 0>
+    static constexpr int impl (::nlpp::impl::Precedence<1>) { return 1; }
+
+    /// Otherwise return false
+    static constexpr int impl (...) { return -1; }
+
+
+    enum{ value = impl(::nlpp::impl::Precedence<0>{}) };
+};
+
+template <class T, class V>
+struct IsBatchFunction : std::integral_constant<bool, (BatchFunctionType<T, V>::value >= 0)> {};
+
+/// A wrapped function is a batch function if the wrapped functor is
+template <class Impl, class V>
+struct IsBatchFunction<impl::Function<Impl>, V> : IsBatchFunction<Impl, V> {};
+
+/** @brief Check if a wrapper (a function/gradient or a cache) holds a batch function
+ *
+ *  @details Every wrapper has a @c batchFunction, falling back to one call per column. This is only true if the
+ *           wrapped functor actually evaluates the whole block at once.
+*/
+template <class T, class V>
+struct HasBatchFunction
+{
+    template <class Impl>
+    static constexpr bool impl (const impl::Function<Impl>*) { return IsBatchFunction<Impl, V>::value; }
+
+    static constexpr bool impl (...) { return false; }
+
+
+    enum{ value = impl(static_cast<const T*>(nullptr)) };
+};
+
+
 /// Check if class T is a gradient functor
 template <class T, class V>
 struct GradientType
@@ -189,14 +251,55 @@ struct Function : public Impl_
     template <class V, class I = Impl, std::enable_if_t<FunctionType<I, V>::value == 0, int> = 0>
     auto function (const Eigen::MatrixBase<V>& x)
     {
-        return Impl::function(x);
+        return Impl::function(x.derived());
     }
 
     template <class V, class I = Impl, std::enable_if_t<FunctionType<I, V>::value == 1, int> = 0>
     auto function (const Eigen::MatrixBase<V>& x)
     {
-        return Impl::operator()(x);
+        return Impl::operator()(x.derived());
     }
+
+    /// If the functor only has the batch interface, evaluate @c x as a single column batch
+    template <class V, class I = Impl, std::enable_if_t<FunctionType<I, V>::value < 0 && IsBatchFunction<I, V>::value, int> = 0>
+    auto function (const Eigen::MatrixBase<V>& x)
+    {
+        return batchFunction(x)(0);
+    }
+
+
+    /** @name
+     *  @brief Evaluate the function at every column of @c X
+     * 
+     *  @details If the functor has a batch interface, the whole block is given in a single call. Otherwise the
+     *           columns are evaluated one at a time.
+     * 
+     *  @returns An Eigen vector with @c X.cols() function values
+    */
+    //@{
+    template <class M, class I = Impl, std::enable_if_t<BatchFunctionType<I, Eigen::Matrix<::nlpp::impl::Scalar<M>, M::RowsAtCompileTime, 1>>::value == 0, int> = 0>
+    auto batchFunction (const Eigen::MatrixBase<M>& X)
+    {
+        return Impl::function(X);
+    }
+
+    template <class M, class I = Impl, std::enable_if_t<BatchFunctionType<I, Eigen::Matrix<::nlpp::impl::Scalar<M>, M::RowsAtCompileTime, 1>>::value == 1, int> = 0>
+    auto batchFunction (const Eigen::MatrixBase<M>& X)
+    {
+        return Impl::operator()(X);
+    }
+
+    template <class M, class I = Impl, std::enable_if_t<BatchFunctionType<I, Eigen::Matrix<::nlpp::impl::Scalar<M>, M::RowsAtCompileTime, 1>>::value < 0, int> = 0>
+    auto batchFunction (const Eigen::MatrixBase<M>& X)
+    {
+        Eigen::Matrix<::nlpp::impl::Scalar<M>, Eigen::Dynamic, 1> fx(X.cols());
+
+        for(int j = 0; j < X.cols(); ++j)
+            fx(j) = function(Eigen::Matrix<::nlpp::impl::Scalar<M>, M::RowsAtCompileTime, 1>(X.col(j)));
+
+        return fx;
+    }
+    //@}
     
 
     template <class V>
@@ -231,13 +334,13 @@ struct Gradient : public Impl_
     template <class V, typename... Args, class I = Impl, std::enable_if_t<GradientType<I, V>::value % 2 == 0, int> = 0>
     auto delegate (const Eigen::MatrixBase<V>& x, Args&&... args)
     {
-        return Impl::gradient(x, std::forward<Args>(args)...);
+        return Impl::gradient(x.derived(), std::forward<Args>(args)...);
     }
 
     template <class V, typename... Args, class I = Impl, std::enable_if_t<GradientType<I, V>::value % 2 == 1, int> = 0>
     auto delegate (const Eigen::MatrixBase<V>& x, Args&&... args)
     {
-        return Impl::operator()(x, std::forward<Args>(args)...);
+        return Impl::operator()(x.derived(), std::forward<Args>(args)...);
     }
 
 
@@ -378,11 +481,11 @@ struct FunctionGradient<Func, Grad> : public Function<Func>, public Gradient<Gra
 };
 
 
-template <class Func, template <class, class> class Difference, class Step>
-struct FunctionGradient<Func, fd::Gradient<Func, Difference, Step>> : Function<Func>, public fd::Gradient<Func, Difference, Step>
+template <class Func, template <class, class, class> class Difference, class Step, class Execution>
+struct FunctionGradient<Func, fd::Gradient<Func, Difference, Step, Execution>> : Function<Func>, public fd::Gradient<Func, Difference, Step, Execution>
 {
     using Function = wrap::Function<Func>;
-    using Gradient = fd::Gradient<Func, Difference, Step>;
+    using Gradient = fd::Gradient<Func, Difference, Step, Execution>;
 
 
     using Function::function;
@@ -392,7 +495,7 @@ struct FunctionGradient<Func, fd::Gradient<Func, Difference, Step>> : Function<F
 
     FunctionGradient (const Function& f = Function{}) : Function(f), Gradient(f) {} 
 
-    FunctionGradient (const Function& f, const Gradient& g) : Function(f), Gradient(Function(f)) {}
+    FunctionGradient (const Function& f, const Gradient& g) : Function(f), Gradient(g) {}
     
 
     /** @name
@@ -446,6 +549,63 @@ struct FunctionGradient<Func, fd::Gradient<Func, Difference, Step>> : Function<F
 };
 
 
+/** @brief Base of the specializations for automatic differentiation gradients
+ * 
+ *  @details The function and gradient values are calculated together by the @c Grad functor
+*/
+template <class Func, class Grad>
+struct AutoDiffFunctionGradient : public Function<Func>, public Grad
+{
+    using Function = wrap::Function<Func>;
+    using Gradient = Grad;
+
+
+    using Function::function;
+    using Gradient::gradient;
+    using Gradient::functionGradient;
+    using Gradient::directional;
+
+
+    AutoDiffFunctionGradient (const Function& f = Function{}) : Function(f), Gradient(f) {} 
+
+    AutoDiffFunctionGradient (const Function& f, const Gradient& g) : Function(f), Gradient(g) {}
+
+
+    template <class V>
+    auto operator () (const Eigen::MatrixBase<V>& x)
+    {
+        return functionGradient(x);
+    }
+
+    /// Necessary to hide a lambda operator matching the exact arguments
+    template <typename T, int R, int C>
+    auto operator () (const Eigen::Matrix<T, R, C>& x)
+    {
+        return functionGradient(x);
+    }
+
+    template <class V>
+    auto operator () (const Eigen::MatrixBase<V>& x, ::nlpp::impl::Plain<V>& g)
+    {
+        return functionGradient(x, g);
+    }
+};
+
+/// Specialization for forward automatic differentiation
+template <class Func, int Lanes>
+struct FunctionGradient<Func, ad::Gradient<Func, Lanes>> : public AutoDiffFunctionGradient<Func, ad::Gradient<Func, Lanes>>
+{
+    using AutoDiffFunctionGradient<Func, ad::Gradient<Func, Lanes>>::AutoDiffFunctionGradient;
+};
+
+/// Specialization for reverse automatic differentiation
+template <class Func, typename Float>
+struct FunctionGradient<Func, ad::Reverse<Func, Float>> : public AutoDiffFunctionGradient<Func, ad::Reverse<Func, Float>>
+{
+    using AutoDiffFunctionGradient<Func, ad::Reverse<Func, Float>>::AutoDiffFunctionGradient;
+};
+
+
 template <class Impl_>
 struct FunctionGradient<Impl_> : public Impl_
 {
@@ -459,13 +619,13 @@ struct FunctionGradient<Impl_> : public Impl_
     template <class V, typename... Args, class I = Impl, std::enable_if_t<FunctionGradientType<I, V>::value % 2 == 0, int> = 0>
     auto delegate (const Eigen::MatrixBase<V>& x, Args&&... args)
     {
-        return Impl::functionGradient(x, std::forward<Args>(args)...);
+        return Impl::functionGradient(x.derived(), std::forward<Args>(args)...);
     }
 
     template <class V, typename... Args, class I = Impl, std::enable_if_t<FunctionGradientType<I, V>::value % 2 != 0, int> = 0>
     auto delegate (const Eigen::MatrixBase<V>& x, Args&&... args)
     {
-        return Impl::operator()(x, std::forward<Args>(args)...);
+        return Impl::operator()(x.derived(), std::forward<Args>(args)...);
     }
 
 
@@ -537,6 +697,18 @@ struct FunctionGradient<Impl_> : public Impl_
         return functionGradient(x, dummieG);
     }
 
+    /// Evaluate the function at every column of @c X, one at a time
+    template <class M>
+    auto batchFunction (const Eigen::MatrixBase<M>& X)
+    {
+        Eigen::Matrix<::nlpp::impl::Scalar<M>, Eigen::Dynamic, 1> fx(X.cols());
+
+        for(int j = 0; j < X.cols(); ++j)
+            fx(j) = function(Eigen::Matrix<::nlpp::impl::Scalar<M>, M::RowsAtCompileTime, 1>(X.col(j)));
+
+        return fx;
+    }
+
     template <class V, class... Args, class I = Impl, std::enable_if_t<GradientType<I, V>::value >= 0, int> = 0>
     auto gradient (const Eigen::MatrixBase<V>& x, Args&&... args)
     {
@@ -556,6 +728,342 @@ struct FunctionGradient<Impl_> : public Impl_
     }
 };
 
+
+
+/** @brief Memoization of the evaluations of a function/gradient wrapper
+ * 
+ *  @details Keeps a ring with the last @c capacity evaluated points, keyed by a hash of the bits of @c x. A point is
+ *           only taken as cached if all of its bits match, so the returned values are exactly the ones the wrapped
+ *           functor would give. On a hit, the values are read from the ring without evaluating or allocating anything,
+ *           and @c find gives direct access to them.
+ * 
+ *           Copies share the same ring and counters, so the cache survives the copies made by the optimizers and
+ *           line searches. It is not thread safe.
+ * 
+ *  @tparam Impl A function/gradient wrapper (impl::FunctionGradient)
+ *  @tparam V The type of the stored points and gradients
+*/
+template <class Impl_, class V_>
+struct Cache : public Impl_
+{
+    using Impl = Impl_;
+    using V = V_;
+    using Float = ::nlpp::impl::Scalar<V>;
+
+
+    /// A cached point, with the function and gradient values already known
+    struct Entry
+    {
+        std::size_t hash;
+        V x;
+        Float f;
+        V g;
+        bool hasFunction = false;
+        bool hasGradient = false;
+    };
+
+    /// Number of evaluations given to the wrapped functor, and number of evaluations saved by the cache
+    struct Counter
+    {
+        long functionCalls = 0;
+        long gradientCalls = 0;
+        long functionHits = 0;
+        long gradientHits = 0;
+    };
+
+    struct State
+    {
+        std::vector<Entry> entries;
+        int next = 0;
+        Counter counter;
+    };
+
+
+    Cache (const Impl& impl, int capacity = 8) : Impl(impl), state(std::make_shared<State>())
+    {
+        state->entries.resize(std::max(capacity, 1));
+    }
+
+
+    template <class U>
+    Float function (const Eigen::MatrixBase<U>& x)
+    {
+        Entry& e = entry(x);
+
+        evaluateFunction(e);
+
+        return e.f;
+    }
+
+
+    template <class U>
+    void gradient (const Eigen::MatrixBase<U>& x, ::nlpp::impl::Plain<U>& g)
+    {
+        Entry& e = entry(x);
+
+        evaluateGradient(e);
+
+        copy(e.g, g);
+    }
+
+    template <class U>
+    ::nlpp::impl::Plain<U> gradient (const Eigen::MatrixBase<U>& x)
+    {
+        Entry& e = entry(x);
+
+        evaluateGradient(e);
+
+        return e.g;
+    }
+
+
+    template <class U>
+    Float functionGradient (const Eigen::MatrixBase<U>& x, ::nlpp::impl::Plain<U>& g)
+    {
+        Entry& e = entry(x);
+
+        evaluateFunctionGradient(e);
+
+        copy(e.g, g);
+
+        return e.f;
+    }
+
+    template <class U>
+    auto functionGradient (const Eigen::MatrixBase<U>& x)
+    {
+        Entry& e = entry(x);
+
+        evaluateFunctionGradient(e);
+
+        return std::make_pair(e.f, ::nlpp::impl::Plain<U>(e.g));
+    }
+
+
+    /** @brief Directional derivative of the function at @c x in the direction @c d
+     * 
+     *  @details If the gradient is known (or exact, so it is worth evaluating and caching it), it is simply
+     *           @f$\nabla f(x)^\intercal d@f$. Otherwise, the finite difference directional derivative is used
+    */
+    //@{
+    template <class U, class W>
+    Float directional (const Eigen::MatrixBase<U>& x, const Eigen::MatrixBase<W>& d)
+    {
+        return directional(x, d, function(x));
+    }
+
+    template <class U, class W>
+    Float directional (const Eigen::MatrixBase<U>& x, const Eigen::MatrixBase<W>& d, Float fx)
+    {
+        return directionalImpl(entry(x), d, fx);
+    }
+    //@}
+
+
+    /// Batch evaluations are not cached, only counted
+    template <class M>
+    auto batchFunction (const Eigen::MatrixBase<M>& X)
+    {
+        state->counter.functionCalls += X.cols();
+
+        return Impl::batchFunction(X);
+    }
+
+
+    template <class U>
+    auto operator () (const Eigen::MatrixBase<U>& x)
+    {
+        return functionGradient(x);
+    }
+
+    /// Necessary to hide a lambda operator matching the exact arguments
+    template <typename T, int R, int C>
+    auto operator () (const Eigen::Matrix<T, R, C>& x)
+    {
+        return functionGradient(x);
+    }
+
+    template <class U>
+    auto operator () (const Eigen::MatrixBase<U>& x, ::nlpp::impl::Plain<U>& g)
+    {
+        return functionGradient(x, g);
+    }
+
+
+    /// The cached entry of @c x, or @c nullptr if there is none. The pointer is valid until the next evaluation
+    template <class U>
+    const Entry* find (const Eigen::MatrixBase<U>& x) const
+    {
+        std::size_t h = hash(x);
+
+        for(const Entry& e : state->entries)
+            if((e.hasFunction || e.hasGradient) && e.hash == h && equal(e.x, x))
+                return &e;
+
+        return nullptr;
+    }
+
+    const Counter& counter () const
+    {
+        return state->counter;
+    }
+
+    /// Forget every cached point and reset the counters
+    void clear ()
+    {
+        for(Entry& e : state->entries)
+            e.hasFunction = e.hasGradient = false;
+
+        state->next = 0;
+        state->counter = Counter{};
+    }
+
+
+    /// Copy a cached gradient, unless @c g is the storage of the cache itself
+    template <class U>
+    static void copy (const V& cached, U& g)
+    {
+        if(g.data() != cached.data())
+            g = cached;
+    }
+
+    /// FNV-1a hash of the bytes of the coefficients of @c x
+    template <class U>
+    static std::size_t hash (const Eigen::MatrixBase<U>& x)
+    {
+        std::size_t h = 14695981039346656037ull;
+        unsigned char bytes[sizeof(Float)];
+
+        for(int i = 0; i < x.size(); ++i)
+        {
+            Float xi = x(i);
+
+            std::memcpy(bytes, &xi, sizeof(Float));
+
+            for(unsigned char b : bytes)
+                h = (h ^ b) * 1099511628211ull;
+        }
+
+        return h;
+    }
+
+    /// Bitwise comparison, so @c -0.0 and @c 0.0 are different points and a @c NaN is equal to itself
+    template <class U>
+    static bool equal (const V& y, const Eigen::MatrixBase<U>& x)
+    {
+        if(y.size() != x.size())
+            return false;
+
+        for(int i = 0; i < x.size(); ++i)
+        {
+            Float xi = x(i);
+
+            if(std::memcmp(&xi, &y(i), sizeof(Float)))
+                return false;
+        }
+
+        return true;
+    }
+
+
+    /// Find the entry of @c x, or take the oldest one of the ring for it
+    template <class U>
+    Entry& entry (const Eigen::MatrixBase<U>& x)
+    {
+        if(const Entry* e = find(x))
+            return const_cast<Entry&>(*e);
+
+        Entry& e = state->entries[state->next];
+
+        state->next = (state->next + 1) % state->entries.size();
+
+        e.hash = hash(x);
+        e.x = x;
+        e.g.resize(x.rows(), x.cols());
+        e.hasFunction = e.hasGradient = false;
+
+        return e;
+    }
+
+    void evaluateFunction (Entry& e)
+    {
+        if(e.hasFunction)
+            return void(state->counter.functionHits++);
+
+        e.f = Impl::function(e.x);
+        e.hasFunction = true;
+
+        state->counter.functionCalls++;
+    }
+
+    void evaluateGradient (Entry& e)
+    {
+        if(e.hasGradient)
+            return void(state->counter.gradientHits++);
+
+        gradientImpl(e);
+        e.hasGradient = true;
+
+        state->counter.gradientCalls++;
+    }
+
+    void evaluateFunctionGradient (Entry& e)
+    {
+        if(e.hasFunction || e.hasGradient)
+        {
+            evaluateFunction(e);
+            evaluateGradient(e);
+
+            return;
+        }
+
+        e.f = Impl::functionGradient(e.x, e.g);
+        e.hasFunction = e.hasGradient = true;
+
+        state->counter.functionCalls++;
+        state->counter.gradientCalls++;
+    }
+
+    /// A finite difference gradient reuses the cached function value at @c x
+    template <class I = Impl, std::enable_if_t<!HasExactGradient<I>::value, int> = 0>
+    void gradientImpl (Entry& e)
+    {
+        if(e.hasFunction)
+            Impl::gradient(e.x, e.g, e.f);
+
+        else
+            Impl::gradient(e.x, e.g);
+    }
+
+    template <class I = Impl, std::enable_if_t<HasExactGradient<I>::value, int> = 0>
+    void gradientImpl (Entry& e)
+    {
+        Impl::gradient(e.x, e.g);
+    }
+
+    template <class W, class I = Impl, std::enable_if_t<!HasExactGradient<I>::value, int> = 0>
+    Float directionalImpl (Entry& e, const Eigen::MatrixBase<W>& d, Float fx)
+    {
+        if(!e.hasGradient)
+            return Impl::directional(e.x, V(d), fx);
+
+        evaluateGradient(e);
+
+        return e.g.dot(d);
+    }
+
+    template <class W, class I = Impl, std::enable_if_t<HasExactGradient<I>::value, int> = 0>
+    Float directionalImpl (Entry& e, const Eigen::MatrixBase<W>& d, Float)
+    {
+        evaluateGradient(e);
+
+        return e.g.dot(d);
+    }
+
+
+    std::shared_ptr<State> state;
+};
+
 } // namespace impl
 
 
@@ -570,13 +1078,13 @@ struct Hessian : public Impl_
     template <class V, typename... Args, class I = Impl, std::enable_if_t<HessianType<I, V>::value % 2 == 0, int> = 0>
     auto delegate (const Eigen::MatrixBase<V>& x, Args&&... args)
     {
-        return Impl::hessian(x, std::forward<Args>(args)...);
+        return Impl::hessian(x.derived(), std::forward<Args>(args)...);
     }
 
     template <class V, typename... Args, class I = Impl, std::enable_if_t<HessianType<I, V>::value % 2 == 1, int> = 0>
     auto delegate (const Eigen::MatrixBase<V>& x, Args&&... args)
     {
-        return Impl::operator()(x, std::forward<Args>(args)...);
+        return Impl::operator()(x.derived(), std::forward<Args>(args)...);
     }
 
 
@@ -598,12 +1106,21 @@ struct Hessian : public Impl_
         return delegate(x) * e;
     }
 
-    template <class V, class I = Impl, std::enable_if_t<GradientType<I, V>::value >= 2, int> = 0>
+    template <class V, class I = Impl, std::enable_if_t<GradientType<I, V>::value >= 2 &&
+              !::nlpp::impl::isSparse<decltype(std::declval<Hessian>().delegate(std::declval<V>()))>, int> = 0>
     ::nlpp::impl::Plain2D<V> hessian (const Eigen::MatrixBase<V>& x)
     {
         return delegate(x);
     }
 
+    /// Sparse hessians are kept sparse
+    template <class V, class I = Impl, std::enable_if_t<GradientType<I, V>::value >= 2 &&
+              ::nlpp::impl::isSparse<decltype(std::declval<Hessian>().delegate(std::declval<V>()))>, int> = 0>
+    Eigen::SparseMatrix<::nlpp::impl::Scalar<V>> hessian (const Eigen::MatrixBase<V>& x)
+    {
+        return delegate(x);
+    }
+
 
     template <class V, class U>
     auto operator() (const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<U>& e)
@@ -619,6 +1136,39 @@ struct Hessian : public Impl_
 };
 
 
+/** @brief The hessian at a point as a linear operator, for methods needing only hessian vector products
+ * 
+ *  @details A product @c hx * e calls @c hessian(x, e, gx) if there is such an interface, as in fd::GradientHessian,
+ *           or @c hessian(x, e) otherwise. The point and its gradient are kept by reference, so the operator follows
+ *           their updates.
+*/
+template <class Hessian, class V>
+struct HessianProduct
+{
+    template <class U>
+    ::nlpp::impl::Plain<V> operator* (const Eigen::MatrixBase<U>& e) const
+    {
+        return product(e.derived(), ::nlpp::impl::Precedence<0>{});
+    }
+
+    template <class U, class H = Hessian, class = decltype(std::declval<H&>()(std::declval<V>(), std::declval<V>(), std::declval<V>()))>
+    ::nlpp::impl::Plain<V> product (const U& e, ::nlpp::impl::Precedence<0>) const
+    {
+        return hessian(x, e, gx);
+    }
+
+    template <class U>
+    ::nlpp::impl::Plain<V> product (const U& e, ::nlpp::impl::Precedence<1>) const
+    {
+        return hessian(x, e);
+    }
+
+    Hessian& hessian;
+    const V& x;
+    const V& gx;
+};
+
+
 /** @name 
  *  @brief Functions used only to delegate the call with automatic type deduction
 */
@@ -668,6 +1218,46 @@ auto hessian (const Impl& impl)
 {
     return Hessian<Impl>(impl);
 }
+
+/** @brief The hessian of @c hess at @c x, for methods needing only products with it
+ * 
+ *  @details A HessianProduct if @c hess has a product interface, or otherwise the whole hessian, dense or sparse,
+ *           evaluated once.
+*/
+template <class Hess, class V, class = decltype(std::declval<Hess&>()(std::declval<V>(), std::declval<V>(), std::declval<V>()))>
+auto hessianOperator (Hess& hess, const V& x, const V& gx, ::nlpp::impl::Precedence<0>)
+{
+    return HessianProduct<Hess, V>{hess, x, gx};
+}
+
+template <class Hess, class V, std::enable_if_t<(HessianType<typename Hess::Impl, V, V>::value < 2), int> = 0>
+auto hessianOperator (Hess& hess, const V& x, const V& gx, ::nlpp::impl::Precedence<1>)
+{
+    return HessianProduct<Hess, V>{hess, x, gx};
+}
+
+template <class Hess, class V>
+auto hessianOperator (Hess& hess, const V& x, const V&, ::nlpp::impl::Precedence<2>)
+{
+    return ::nlpp::impl::Plain<decltype(hess(x))>(hess(x));
+}
+
+template <class Hess, class V>
+auto hessianOperator (Hess& hess, const V& x, const V& gx)
+{
+    return hessianOperator(hess, x, gx, ::nlpp::impl::Precedence<0>{});
+}
+
+/** @brief Memoize the evaluations of a function/gradient functor (or of a function only)
+ * 
+ *  @param impl Anything accepted by functionGradient
+ *  @param capacity Number of points kept in the cache
+*/
+template <class V = Vec, class Impl>
+auto cache (const Impl& impl, int capacity = 8)
+{
+    return impl::Cache<FunctionGradient<Impl>, V>(FunctionGradient<Impl>(impl), capacity);
+}
 //@}
 
 //@}
@@ -701,6 +1291,18 @@ struct Function
         return function(x);
     }
 
+    /// Evaluate the function at every column of @c X, one at a time
+    template <class M>
+    Eigen::Matrix<Float, Eigen::Dynamic, 1> batchFunction (const Eigen::MatrixBase<M>& X)
+    {
+        Eigen::Matrix<Float, Eigen::Dynamic, 1> fx(X.cols());
+
+        for(int j = 0; j < X.cols(); ++j)
+            fx(j) = func(X.col(j));
+
+        return fx;
+    }
+
     std::function<FuncType> func;
 };
 
@@ -29,11 +29,50 @@ struct Backtracking
 	}
 
 
+	void initialize () {}
+
+
 	/** @brief The line search procedure
 	 *  @param f A function/gradient functor, projected on a single dimension
 	*/
 	template <class Function>
 	Float lineSearch (Function f)
+	{
+		return lineSearch(f, Precedence<0>{});
+	}
+
+	/// If the function has a batch interface, the next @c batchSize steps are evaluated in a single block
+	template <class Function, std::enable_if_t<Function::isBatch, int> = 0>
+	Float lineSearch (Function f, Precedence<0>)
+	{
+		Float f0, g0, a = a0;
+
+		std::tie(f0, g0) = f(0.0);
+
+		Eigen::Matrix<Float, Eigen::Dynamic, 1> as(batchSize);
+
+		while(a > aMin)
+		{
+			int k = 0;
+
+			for(; k < batchSize && a > aMin; ++k, a = rho * a)
+				as(k) = a;
+
+			auto fs = f.function(as.head(k));
+
+			for(int j = 0; j < k; ++j) if(fs(j) <= f0 + c * as(j) * g0)
+			{
+				f.record(as(j), fs(j));
+
+				return as(j);
+			}
+		}
+
+		return a;
+	}
+
+	template <class Function>
+	Float lineSearch (Function f, Precedence<1>)
 	{
 		Float f0, g0, a = a0;
 
@@ -54,12 +93,59 @@ struct Backtracking
 	Float aMin;	///< Smallest step acceptable
 
 	Float rho;		///< Factor to reduce @c a
+
+	int batchSize = 4;	///< Number of steps evaluated together with a batch function
 };
 
 } // namespace impl
 
 
-NLPP_LINE_SEARCH(Backtracking)
+template <typename Float = types::Float>
+struct Backtracking : public impl::Backtracking<Float>,
+					  public LineSearch<Backtracking<Float>>
+{
+	using Interface = LineSearch<Backtracking<Float>>;
+	using Impl = impl::Backtracking<Float>;
+	using Impl::Impl;
+
+	void initialize ()
+	{
+		Impl::initialize();
+	}
+
+	template <class Function>
+	auto lineSearch (Function f)
+	{
+		return Impl::lineSearch(f);
+	}
+};
+
+
+namespace poly
+{
+
+template <typename Float = types::Float>
+struct Backtracking : public impl::Backtracking<Float>,
+					  public LineSearch<Float>
+{
+	using Interface = LineSearch<Float>;
+	using Impl = impl::Backtracking<Float>;
+	using Impl::Impl;
+
+	void initialize ()
+	{
+		Impl::initialize();
+	}
+
+	Float lineSearch (::nlpp::wrap::LineSearch<::nlpp::wrap::poly::FunctionGradient<>, ::nlpp::Vec> f)
+	{
+		return Impl::lineSearch(f);
+	}
+
+	virtual Backtracking* clone_impl () const { return new Backtracking(*this); }
+};
+
+} // namespace poly
 
 
 } // namespace nlpp
\ No newline at end of file
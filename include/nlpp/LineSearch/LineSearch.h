@@ -26,37 +26,118 @@ struct LineSearch
 {
 	using Float = typename V::Scalar;
 
-	LineSearch (const FunctionGradient& f, const V& x, const V& d) : f(f), x(x), d(d), gx(x.rows(), x.cols())
+	/// If the wrapped function evaluates a block of points at once, so line searches can probe several steps together
+	enum { isBatch = HasBatchFunction<FunctionGradient, V>::value };
+
+	/** @brief The last point evaluated by the line search
+	 * 
+	 *  @details Shared by every copy of the wrapper, so the optimizer can take the function value (and the gradient,
+	 * 			 if it was calculated) at the accepted step instead of evaluating it again. Gradients are written
+	 * 			 directly on the buffer @c gx of the optimizer, and every trial point on the buffer @c xn.
+	*/
+	struct Evaluation
+	{
+		::nlpp::impl::Plain<V>& gx;
+		::nlpp::impl::Plain<V>& xn;
+		Float a = std::numeric_limits<Float>::quiet_NaN();
+		Float fx = 0.0;
+		bool hasGradient = false;
+	};
+
+
+	LineSearch (const FunctionGradient& f, const V& x, const V& d, Evaluation& last) : f(f), x(x), d(d), last(last)
 	{
 	}
 
+	/** @brief Function value and directional derivative at @c a
+	 * 
+	 *  @details If the wrapped function has an exact gradient, a single fused call evaluates both the function and
+	 * 			 its gradient on the buffer @c last.gx, and the directional derivative is simply @f$\nabla f^\intercal d@f$.
+	 * 			 Otherwise, it falls back to the (finite difference) directional derivative, given the function value.
+	*/
+	//@{
+	template <class F = FunctionGradient, std::enable_if_t<HasExactGradient<F>::value, int> = 0>
 	std::pair<Float, Float> operator () (Float a)
 	{
-		// auto fx = f(x + a * d, gx);
+		last.xn.noalias() = x + a * d;
+
+		Float fx = f(last.xn, last.gx);
+
+		record(a, fx, true);
 
-		// return std::make_pair(fx, gx.dot(d));
+		return std::make_pair(fx, last.gx.dot(d));
+	}
+
+	template <class F = FunctionGradient, std::enable_if_t<!HasExactGradient<F>::value, int> = 0>
+	std::pair<Float, Float> operator () (Float a)
+	{
+		last.xn.noalias() = x + a * d;
 
-		V xn = x + a * d;
+		Float fx = f.function(last.xn);
 
-		Float fx = f.function(xn);
+		Float gx = f.directional(last.xn, d, fx);
 
-		Float gx = f.directional(xn, d, fx);
+		record(a, fx);
 
 		return std::make_pair(fx, gx);
 	}
+	//@}
 
 	Float function (Float a)
 	{
-		return f.function(x + a * d);
+		last.xn.noalias() = x + a * d;
+
+		Float fx = f.function(last.xn);
+
+		record(a, fx);
+
+		return fx;
+	}
+
+	/** @brief Evaluate the function at every step size of @c a, as a single block if the function has a batch interface
+	 * 
+	 *  @details Nothing is recorded, so a line search accepting one of these steps must call @c record itself.
+	*/
+	template <class A>
+	Eigen::Matrix<Float, Eigen::Dynamic, 1> function (const Eigen::MatrixBase<A>& a)
+	{
+		Eigen::Matrix<Float, V::RowsAtCompileTime, Eigen::Dynamic> xs = x.replicate(1, a.size()) + d * a.transpose();
+
+		return f.batchFunction(xs);
+	}
+
+	/// Directional derivative at @c a. Keeps the gradient of the last evaluation if it was made at the same step
+	//@{
+	template <class F = FunctionGradient, std::enable_if_t<HasExactGradient<F>::value, int> = 0>
+	Float gradient (Float a)
+	{
+		if(a != last.a || !last.hasGradient)
+		{
+			last.xn.noalias() = x + a * d;
+
+			f.gradient(last.xn, last.gx);
+
+			last.hasGradient = a == last.a;
+		}
+
+		return last.gx.dot(d);
 	}
 
+	template <class F = FunctionGradient, std::enable_if_t<!HasExactGradient<F>::value, int> = 0>
 	Float gradient (Float a)
 	{
-		// f.gradient(x + a * d, gx);
+		last.xn.noalias() = x + a * d;
+
+		return f.directional(last.xn, d);
+	}
+	//@}
 
-		// return gx.dot(d);
 
-		return f.directional(x, d);
+	void record (Float a, Float fx, bool hasGradient = false)
+	{
+		last.a = a;
+		last.fx = fx;
+		last.hasGradient = hasGradient;
 	}
 
 
@@ -65,7 +146,7 @@ struct LineSearch
 	const V& x;
 	const V& d;
 
-	typename V::PlainObject gx;
+	Evaluation& last;
 };
 
 } // namespace wrap
@@ -100,9 +181,73 @@ struct LineSearch
     template <class Function, class V>
 	auto impl (Function f, const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<V>& dir)
 	{
-		return static_cast<Impl&>(*this).lineSearch(wrap::LineSearch<Function, V>(f, x, dir));
+		::nlpp::impl::Scalar<V> fx;
+		::nlpp::impl::Plain<V> gx(x.rows(), x.cols());
+
+		return impl(f, x, dir, fx, gx);
+	}
+
+    template <class Function, class V>
+	auto impl (Function f, const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<V>& dir,
+			   ::nlpp::impl::Scalar<V>& fx, ::nlpp::impl::Plain<V>& gx)
+	{
+		::nlpp::impl::Plain<V> xn(x.rows(), x.cols());
+
+		return impl(f, x, dir, fx, gx, xn);
 	}
 
+	/** @brief Line search, also returning the function value @c fx and gradient @c gx at the accepted step
+	 * 
+	 *  @details If the last point evaluated by the line search is the accepted step, its function value is reused,
+	 * 			 so only the gradient is evaluated (or nothing at all, if the line search already calculated it).
+	 * 
+	 *  @param xn Buffer for the trial points, holding the accepted point @f$x + a d@f$ at the end
+	*/
+    template <class Function, class V>
+	auto impl (Function f, const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<V>& dir,
+			   ::nlpp::impl::Scalar<V>& fx, ::nlpp::impl::Plain<V>& gx, ::nlpp::impl::Plain<V>& xn)
+	{
+		typename wrap::LineSearch<Function, V>::Evaluation last{gx, xn};
+
+		auto a = static_cast<Impl&>(*this).lineSearch(wrap::LineSearch<Function, V>(f, x.derived(), dir.derived(), last));
+
+		last.xn.noalias() = x + a * dir;
+
+		if(last.a != a)
+			fx = f(last.xn, gx);
+
+		else
+		{
+			fx = last.fx;
+
+			if(!last.hasGradient)
+				gradient(f, last.xn, gx, fx, ::nlpp::impl::Precedence<0>{});
+		}
+
+		return a;
+	}
+
+	/// Gradient at @c x given @c fx, if the wrapper can use it, or the exact gradient alone. Otherwise evaluate both
+	//@{
+	template <class Function, class V, typename Float>
+	static auto gradient (Function& f, const V& x, V& gx, Float& fx, ::nlpp::impl::Precedence<0>) -> decltype(f.gradient(x, gx, fx), void())
+	{
+		f.gradient(x, gx, fx);
+	}
+
+	template <class Function, class V, typename Float, std::enable_if_t<wrap::HasExactGradient<Function>::value, int> = 0>
+	static void gradient (Function& f, const V& x, V& gx, Float&, ::nlpp::impl::Precedence<1>)
+	{
+		f.gradient(x, gx);
+	}
+
+	template <class Function, class V, typename Float>
+	static void gradient (Function& f, const V& x, V& gx, Float& fx, ::nlpp::impl::Precedence<2>)
+	{
+		fx = f(x, gx);
+	}
+	//@}
+
 
 	template <class Function, class V, class I = Impl, std::enable_if_t<!isImplPoly<I>, int> = 0>
 	auto operator () (const Function& f, const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<V>& dir)
@@ -116,6 +261,20 @@ struct LineSearch
 		return impl(wrap::functionGradient(f, g), x, dir);
 	}
 
+	template <class Function, class V, class I = Impl, std::enable_if_t<!isImplPoly<I>, int> = 0>
+	auto operator () (const Function& f, const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<V>& dir,
+					  ::nlpp::impl::Scalar<V>& fx, ::nlpp::impl::Plain<V>& gx)
+	{
+	    return impl(wrap::functionGradient(f), x, dir, fx, gx);
+	}
+
+	template <class Function, class V, class I = Impl, std::enable_if_t<!isImplPoly<I>, int> = 0>
+	auto operator () (const Function& f, const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<V>& dir,
+					  ::nlpp::impl::Scalar<V>& fx, ::nlpp::impl::Plain<V>& gx, ::nlpp::impl::Plain<V>& xn)
+	{
+	    return impl(wrap::functionGradient(f), x, dir, fx, gx, xn);
+	}
+
 
 
 	template <class Function, class V, class I = Impl, std::enable_if_t<isImplPoly<I>, int> = 0>
@@ -129,6 +288,20 @@ struct LineSearch
 	{
 		return impl(wrap::poly::FunctionGradient<V>(f, g), x, dir);
     }
+
+	template <class Function, class V, class I = Impl, std::enable_if_t<isImplPoly<I>, int> = 0>
+	auto operator () (const Function& f, const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<V>& dir,
+					  ::nlpp::impl::Scalar<V>& fx, ::nlpp::impl::Plain<V>& gx)
+	{
+		return impl(wrap::poly::FunctionGradient<V>(f), x, dir, fx, gx);
+	}
+
+	template <class Function, class V, class I = Impl, std::enable_if_t<isImplPoly<I>, int> = 0>
+	auto operator () (const Function& f, const Eigen::MatrixBase<V>& x, const Eigen::MatrixBase<V>& dir,
+					  ::nlpp::impl::Scalar<V>& fx, ::nlpp::impl::Plain<V>& gx, ::nlpp::impl::Plain<V>& xn)
+	{
+		return impl(wrap::poly::FunctionGradient<V>(f), x, dir, fx, gx, xn);
+	}
 	
 
     // template <class Function, class Gradient, typename Float, std::enable_if_t<std::is_floating_point<Float>::value, int> = 0>
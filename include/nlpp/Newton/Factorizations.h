@@ -2,11 +2,89 @@
 
 #include "../Helpers/Helpers.h"
 
+#include <vector>
+#include <algorithm>
+
 
 
 namespace nlpp
 {
 
+namespace impl
+{
+
+/** @brief Factorization of a symmetric matrix: Eigen::LDLT for dense matrices, Eigen::SimplicialLDLT for sparse ones
+ *
+ *  @details For sparse matrices, the symbolic analysis (the fill reducing ordering and the elimination tree) is kept,
+ * 			 along with a copy of the pattern it was made for, and only the numeric factorization is redone while the
+ * 			 pattern is the same. The pattern of a hessian usually does not change between iterations, so it is
+ * 			 analyzed once.
+*/
+template <class M, bool Sparse = isSparse<M>>
+struct SymmetricSolver
+{
+	template <class U>
+	void compute (const U& m)
+	{
+		ldlt.compute(m);
+	}
+
+	template <class V>
+	auto solve (const V& v) const
+	{
+		return ldlt.solve(v);
+	}
+
+	Eigen::LDLT<M> ldlt;
+};
+
+template <class M>
+struct SymmetricSolver<M, true>
+{
+	using StorageIndex = typename M::StorageIndex;
+
+	void compute (const M& m)
+	{
+		if(!samePattern(m))
+		{
+			ldlt.analyzePattern(m);
+
+			if(m.isCompressed())
+			{
+				outerIndex.assign(m.outerIndexPtr(), m.outerIndexPtr() + m.outerSize() + 1);
+				innerIndex.assign(m.innerIndexPtr(), m.innerIndexPtr() + m.nonZeros());
+			}
+			else
+				outerIndex.clear();
+		}
+
+		ldlt.factorize(m);
+	}
+
+	template <class V>
+	auto solve (const V& v) const
+	{
+		return ldlt.solve(v);
+	}
+
+	/// If @c m has exactly the pattern of the last analysis. Uncompressed matrices are always analyzed again
+	bool samePattern (const M& m) const
+	{
+		return m.isCompressed() && !outerIndex.empty() && Eigen::Index(outerIndex.size()) == m.outerSize() + 1 &&
+			   Eigen::Index(innerIndex.size()) == m.nonZeros() &&
+			   std::equal(outerIndex.begin(), outerIndex.end(), m.outerIndexPtr()) &&
+			   std::equal(innerIndex.begin(), innerIndex.end(), m.innerIndexPtr());
+	}
+
+	Eigen::SimplicialLDLT<M> ldlt;
+
+	std::vector<StorageIndex> outerIndex;	///< Pattern of the last analysis, as the compressed indices
+	std::vector<StorageIndex> innerIndex;
+};
+
+} // namespace impl
+
+
 namespace fact
 {
 
@@ -15,28 +93,74 @@ struct SimplyInvert
 	template <class V, class U>
 	impl::Plain<V> operator () (const Eigen::MatrixBase<V>& grad, const Eigen::MatrixBase<U>& hess)
 	{
-		return -hess.colPivHouseholderQr().solve(grad);
+		factorize(hess);
+
+		impl::Plain<V> dir;
+
+		direction(grad, dir);
+
+		return dir;
+	}
+
+	template <class U>
+	void factorize (const Eigen::MatrixBase<U>& hess)
+	{
+		qr.compute(hess);
 	}
+
+	template <class V>
+	void direction (const Eigen::MatrixBase<V>& grad, impl::Plain<V>& dir) const
+	{
+		dir = -qr.solve(grad);
+	}
+
+
+	Eigen::ColPivHouseholderQR<Mat> qr;
 };
 
 
 template <typename Float = types::Float>
 struct SmallIdentity
 {
+	using MatX = Eigen::Matrix<Float, Eigen::Dynamic, Eigen::Dynamic>;
+
 	SmallIdentity (Float alpha = 1e-5) : alpha(alpha) {}
 
 	template <class V, class U>
-	impl::Plain<V> operator () (const Eigen::MatrixBase<V>& grad, U hess)
+	impl::Plain<V> operator () (const Eigen::MatrixBase<V>& grad, const Eigen::MatrixBase<U>& hess)
+	{
+		factorize(hess);
+
+		impl::Plain<V> dir;
+
+		direction(grad, dir);
+
+		return dir;
+	}
+
+	template <class U>
+	void factorize (const Eigen::MatrixBase<U>& hess_)
 	{
+		MatX hess = hess_;
+
 		auto minDiag = hess.diagonal().array().minCoeff();
 
 		if(minDiag < 0.0)
 			hess.diagonal().array() += minDiag + alpha;
 
-		return -hess.colPivHouseholderQr().solve(grad);
+		qr.compute(hess);
 	}
 
+	template <class V>
+	void direction (const Eigen::MatrixBase<V>& grad, impl::Plain<V>& dir) const
+	{
+		dir = -qr.solve(grad);
+	}
+
+
 	Float alpha;
+
+	Eigen::ColPivHouseholderQR<MatX> qr;
 };
 
 
@@ -44,11 +168,28 @@ struct SmallIdentity
 template <typename Float = types::Float>
 struct CholeskyIdentity
 {
+	using MatX = Eigen::Matrix<Float, Eigen::Dynamic, Eigen::Dynamic>;
+
 	CholeskyIdentity (Float beta = 1e-3, Float c = 2.0, Float maxTau = 1e8) : beta(beta), c(c), maxTau(maxTau) {}
 
 	template <class V, class U>
-	impl::Plain<V> operator () (const Eigen::MatrixBase<V>& grad, U hess)
+	impl::Plain<V> operator () (const Eigen::MatrixBase<V>& grad, const Eigen::MatrixBase<U>& hess)
+	{
+		factorize(hess);
+
+		impl::Plain<V> dir;
+
+		direction(grad, dir);
+
+		return dir;
+	}
+
+	/// If no shift up to @c maxTau gives a positive definite matrix, the factor is of the identity
+	template <class U>
+	void factorize (const Eigen::MatrixBase<U>& hess_)
 	{
+		MatX hess = hess_;
+
 		impl::PlainArray<U> orgDiag = hess.diagonal().array();
 
 		auto minDiag = orgDiag.minCoeff();
@@ -57,117 +198,231 @@ struct CholeskyIdentity
 
 		while(tau < maxTau)
 		{
-			Eigen::LLT<impl::Plain<U>> llt(hess);
+			llt.compute(hess);
 
 			if(llt.info() == Eigen::Success)
-				return -llt.solve(grad);
+				return;
 
 			hess.diagonal().array() = orgDiag + tau;
 
 			tau = std::max(c * tau, beta);
 		}
 
-		return -grad;
+		llt.compute(MatX::Identity(hess.rows(), hess.cols()));
 	}
 
+	template <class V>
+	void direction (const Eigen::MatrixBase<V>& grad, impl::Plain<V>& dir) const
+	{
+		dir = -llt.solve(grad);
+	}
+
+
 	Float beta;
 	Float c;
 	Float maxTau;
+
+	Eigen::LLT<MatX> llt;
 };
 
 
+/** @brief Sparse version of CholeskyIdentity: factorizes @f$H + \tau I@f$ with a SimplicialLDLT, increasing @f$\tau@f$
+ * 		   until @f$D@f$ is positive
+ *
+ *  @details The shift is added to a matrix that always has the full diagonal in its pattern, so every trial and every
+ * 			 iteration share the same symbolic analysis.
+*/
 template <typename Float = types::Float>
-struct CholeskyFactorization
+struct SparseCholeskyIdentity
 {
-	CholeskyFactorization (Float delta = 1e-3) : delta(delta) {}
+	using Sparse = Eigen::SparseMatrix<Float>;
+
+	SparseCholeskyIdentity (Float beta = 1e-3, Float c = 2.0, Float maxTau = 1e8) : beta(beta), c(c), maxTau(maxTau) {}
 
-	Vec operator () (const Vec& grad, Mat hess)
+	template <class V, class U>
+	impl::Plain<V> operator () (const Eigen::MatrixBase<V>& grad, const Eigen::SparseMatrixBase<U>& hess)
 	{
-		int N = hess.rows();
+		factorize(hess);
 
-		double maxDiag = -1e20, maxOffDiag = -1e20;
+		impl::Plain<V> dir;
 
-		for(int i = 0; i < N; ++i)
+		direction(grad, dir);
+
+		return dir;
+	}
+
+	/// If no shift up to @c maxTau gives a positive definite matrix, the factor is of the identity
+	template <class U>
+	void factorize (const Eigen::SparseMatrixBase<U>& hess)
+	{
+		if(identity.rows() != hess.rows())
+		{
+			identity.resize(hess.rows(), hess.cols());
+			identity.setIdentity();
+		}
+
+		shifted = hess + Float(0.0) * identity;
+
+		Float minDiag = shifted.diagonal().minCoeff();
+
+		Float tau = 0.0, next = minDiag < 0.0 ? beta - minDiag : beta;
+
+		while(tau < maxTau)
 		{
-			maxDiag = std::max(maxDiag, std::abs(hess(i, i)));
+			if(tau > 0.0)
+				shifted = hess + tau * identity;
+
+			solver.compute(shifted);
 
-			for(int j = 0; j < N; ++j) if(i != j)
-				maxOffDiag = std::max(maxOffDiag, std::abs(hess(i, j)));
+			if(solver.ldlt.info() == Eigen::Success && solver.ldlt.vectorD().minCoeff() > 0.0)
+				return;
+
+			tau = next;
+			next = c * next;
 		}
 
-		double beta = std::max(constants::eps, std::max(maxDiag, maxOffDiag / std::max(1.0, sqrt(N*N - 1.0))));
+		shifted = Float(0.0) * hess + identity;
 
+		solver.compute(shifted);
+	}
 
-		Mat L = Mat::Identity(N, N);
-		Mat C = Mat::Identity(N, N);
-		Mat D = Mat::Constant(N, N, 0.0);
-		Mat E = Mat::Constant(N, N, 0.0);
-		Mat Q = Mat::Identity(N, N);
-		Mat O = Mat::Identity(N, N);
+	template <class V>
+	void direction (const Eigen::MatrixBase<V>& grad, impl::Plain<V>& dir) const
+	{
+		dir = -solver.solve(grad);
+	}
 
 
-		for(int i = 0; i < N; ++i)
-			C(i, i) = hess(i, i);
+	Float beta;
+	Float c;
+	Float maxTau;
 
+	Sparse identity;
+	Sparse shifted;		///< The last matrix factorized, @f$H + \tau I@f$
 
-		for(int i = 0; i < N; ++i)
+	impl::SymmetricSolver<Sparse> solver;
+};
+
+
+/** @brief Modified Cholesky factorization of Gill, Murray and Wright, with symmetric pivoting
+ *
+ *  @details Computes @f$P (H + E) P^\intercal = L D L^\intercal@f$, where @f$E@f$ is a nonnegative diagonal, zero if
+ * 			 @f$H@f$ is sufficiently positive definite. At step @c j the largest remaining diagonal is swapped in, and
+ * 			 @f$d_j = \max(\delta, |c_{jj}|, \theta_j^2 / \beta^2)@f$, where @f$\theta_j@f$ is the largest element of the
+ * 			 column below the diagonal and @f$\beta^2 = \max(\gamma, \xi / \sqrt{N^2 - 1}, \epsilon)@f$ bounds the
+ * 			 elements of @f$L D^{1/2}@f$.
+ *
+ * 			 The factorization is right looking and done in place, on the lower triangle of @c ldl, with the pivots
+ * 			 as swaps of indices. It takes about @f$N^3/3@f$ flops, and the direction is two triangular solves.
+*/
+template <typename Float = types::Float>
+struct CholeskyFactorization
+{
+	using MatX = Eigen::Matrix<Float, Eigen::Dynamic, Eigen::Dynamic>;
+
+	CholeskyFactorization (Float delta = 1e-3) : delta(delta) {}
+
+	template <class V, class U>
+	impl::Plain<V> operator () (const Eigen::MatrixBase<V>& grad, const Eigen::MatrixBase<U>& hess)
+	{
+		factorize(hess);
+
+		impl::Plain<V> dir;
+
+		direction(grad, dir);
+
+		return dir;
+	}
+
+
+	/// Factorizes @c hess, copying only its lower triangle
+	template <class U>
+	void factorize (const Eigen::MatrixBase<U>& hess)
+	{
+		int N = hess.rows();
+
+		ldl.resize(N, N);
+		ldl.template triangularView<Eigen::Lower>() = hess.template triangularView<Eigen::Lower>();
+
+		transpositions.resize(N);
+
+		Float gamma = ldl.diagonal().cwiseAbs().maxCoeff(), xi = 0.0;
+
+		for(int j = 0; j < N - 1; ++j)
+			xi = std::max(xi, ldl.col(j).tail(N - j - 1).cwiseAbs().maxCoeff());
+
+		Float beta2 = std::max({gamma, xi / std::max(Float(1.0), std::sqrt(Float(N) * N - 1)), constants::eps_<Float>});
+
+		for(int j = 0; j < N; ++j)
 		{
-			double val = -1e20;
-			int p = 0;
+			int q;
 
-			for(int j = i; j < N; ++j) if(std::abs(hess(j, j)) > val)
-				val = std::abs(hess(j, j)), p = j;
+			ldl.diagonal().tail(N - j).cwiseAbs().maxCoeff(&q);
 
-			if(p != i)
-			{
-				Mat P = Mat::Identity(N, N);
+			q += j;
 
-				P(i, i) = P(p, p) = 0.0;
-				P(i, p) = P(p, i) = 1.0;
+			transpositions.coeffRef(j) = q;
 
-				hess = P * hess * P.transpose();
+			if(q != j)
+				swap(j, q);
 
-				Q = P * Q;
-				O = O * P.transpose();
-			}
+			int r = N - j - 1;
 
+			auto c = ldl.col(j).tail(r);
 
+			Float theta = r > 0 ? c.cwiseAbs().maxCoeff() : Float(0.0);
 
-			double phi = -1e20;
+			Float d = std::max({delta, std::abs(ldl(j, j)), theta * theta / beta2});
 
-			for(int j = 0; j < i; ++j)
-				L(i, j) = C(i, j) / D(j, j);
+			ldl(j, j) = d;
 
-			for(int j = i+1; j < N; ++j)
+			/// Lower triangle of the trailing matrix minus c c' / d, and then the column of L
+			if(r > 0)
 			{
-				C(j, i) = hess(j, i);
+				ldl.bottomRightCorner(r, r).template selfadjointView<Eigen::Lower>().rankUpdate(c, -1.0 / d);
 
-				for(int k = 0; k < i; ++k)
-					C(j, i) -= L(i, k) * C(j, k);
-				
-				phi = std::max(phi, std::abs(C(j, i)));
+				c /= d;
 			}
+		}
+	}
 
-			if(i == N-1)
-				phi = 0.0;
+	/// Solves @f$(H + E) p = -g@f$ with the last factorization
+	template <class V>
+	void direction (const Eigen::MatrixBase<V>& grad, impl::Plain<V>& dir) const
+	{
+		dir = transpositions * grad;
 
-			D(i, i) = std::max(delta, std::max(std::abs(C(i, i)), pow(phi, 2) / beta));
+		ldl.template triangularView<Eigen::UnitLower>().solveInPlace(dir);
 
-			E(i, i) = D(i, i) - C(i, i);
+		dir.array() /= ldl.diagonal().array();
 
+		ldl.template triangularView<Eigen::UnitLower>().transpose().solveInPlace(dir);
 
-			for(int j = i+1; j < N; ++j)
-				C(j, j) = C(j, j) - pow(C(j, i), 2) / D(i, i);
-		}
+		dir = -(transpositions.transpose() * dir);
+	}
+
+
+	/// Symmetric swap of rows and columns @c j and @c q > @c j, reading and writing only the lower triangle
+	void swap (int j, int q)
+	{
+		int N = ldl.rows();
 
+		ldl.row(j).head(j).swap(ldl.row(q).head(j));
 
-		hess = Q.inverse() * (hess + E) * O.inverse();
+		std::swap(ldl(j, j), ldl(q, q));
 
-		return -hess.colPivHouseholderQr().solve(grad);
+		for(int i = j + 1; i < q; ++i)
+			std::swap(ldl(i, j), ldl(q, i));
+
+		ldl.col(j).tail(N - q - 1).swap(ldl.col(q).tail(N - q - 1));
 	}
 
 
-	double delta;
+	Float delta;	///< Smallest element of @f$D@f$
+
+	MatX ldl;		///< @f$L@f$ below the diagonal, @f$D@f$ on the diagonal
+
+	Eigen::Transpositions<Eigen::Dynamic> transpositions;	///< The pivots, @f$P@f$
 };
 
 
@@ -178,7 +433,20 @@ struct IndefiniteFactorization
 	IndefiniteFactorization (double delta = 1e-2) : delta(delta) {}
 
 
-	Vec operator () (const Vec& grad, Mat hess)
+	template <class V, class U>
+	impl::Plain<V> operator () (const Eigen::MatrixBase<V>& grad, const Eigen::MatrixBase<U>& hess)
+	{
+		factorize(hess);
+
+		impl::Plain<V> dir;
+
+		direction(grad, dir);
+
+		return dir;
+	}
+
+	template <class U>
+	void factorize (const Eigen::MatrixBase<U>& hess)
 	{
 		int N = hess.rows();
 
@@ -200,10 +468,23 @@ struct IndefiniteFactorization
 		F = schur.matrixT() + eigVec * F * eigVec.transpose();
 
 
-		return -schur.matrixU() * F.llt().solve(Mat::Identity(N, N)) * schur.matrixU().transpose() * grad;
+		U_ = schur.matrixU();
+
+		llt.compute(F);
 	}
 
+	template <class V>
+	void direction (const Eigen::MatrixBase<V>& grad, impl::Plain<V>& dir) const
+	{
+		dir = -U_ * llt.solve(U_.transpose() * grad);
+	}
+
+
 	double delta;
+
+	Mat U_;					///< Orthogonal factor of the Schur decomposition
+
+	Eigen::LLT<Mat> llt;	///< Factorization of the modified quasi triangular factor
 };
 
 } // namespace fact
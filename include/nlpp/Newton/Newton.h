@@ -10,7 +10,8 @@
 
 
 #define CPPOPT_USING_PARAMS_NEWTON(...) CPPOPT_USING_PARAMS(__VA_ARGS__);	\
-										using Params::factorization;
+										using Params::factorization;		\
+										using Params::refresh;
 
 
 
@@ -18,19 +19,76 @@
 namespace nlpp
 {
 
+/** @name
+ *  @brief When the hessian is evaluated and factorized again
+ *
+ *  @details Called after each iteration with the ratio @f$\|g_{k+1}\| / \|g_k\|@f$ and whether the last direction came
+ * 			 from a new factorization, returns whether the next one must.
+*/
+//@{
+namespace newton
+{
+
+/// A new factorization on every iteration: the classical Newton method
+struct Always
+{
+	void initialize () {}
+
+	template <typename Float>
+	bool operator () (bool, Float) const
+	{
+		return true;
+	}
+};
+
+/** @brief Reuses a factorization for up to @c k iterations (the Shamanskii method), or until the gradient norm is not
+ * 		   reduced by at least @c maxRatio
+ *
+ *  @details With @c k = 1 it is the Newton method, and with a large @c k the chord method. Near the solution the
+ * 			 hessian changes slowly, so an old factorization still gives a fast (linear) decrease of the gradient.
+*/
+template <typename Float = types::Float>
+struct Shamanskii
+{
+	Shamanskii (int k = 5, Float maxRatio = 0.5) : k(k), maxRatio(maxRatio) {}
+
+	void initialize ()
+	{
+		age = 0;
+	}
+
+	bool operator () (bool refreshed, Float ratio)
+	{
+		age = refreshed ? 1 : age + 1;
+
+		return age >= k || !(ratio <= maxRatio);
+	}
+
+	int k;				///< Maximum number of directions from a single factorization
+	Float maxRatio;		///< Largest ratio of gradient norms accepted without a new factorization
+
+	int age = 0;		///< Directions taken from the current factorization
+};
+
+} // namespace newton
+//@}
+
+
 namespace impl
 {
 
 namespace params
 {
 
-template <class Params_, class Factorization = ::nlpp::fact::SmallIdentity<>>
+template <class Params_, class Factorization = ::nlpp::fact::SmallIdentity<>, class Refresh = ::nlpp::newton::Always>
 struct Newton : public Params_
 {
 	CPPOPT_USING_PARAMS(Params, Params_);
 	using Params::Params;
 
-	Factorization factorization;
+	Factorization factorization;	///< Also holds the factor of the last hessian evaluated
+
+	Refresh refresh;
 };
 
 
@@ -38,35 +96,55 @@ struct Newton : public Params_
 
 
 
-template <class Params_, class Factorization = ::nlpp::fact::SmallIdentity<>>
-struct Newton : public params::Newton<Params_, Factorization>
+template <class Params_, class Factorization = ::nlpp::fact::SmallIdentity<>, class Refresh = ::nlpp::newton::Always>
+struct Newton : public params::Newton<Params_, Factorization, Refresh>
 {
-	CPPOPT_USING_PARAMS_NEWTON(Params, params::Newton<Params_, Factorization>);
+	CPPOPT_USING_PARAMS_NEWTON(Params, params::Newton<Params_, Factorization, Refresh>);
 	using Params::Params;
 
 
+	/** @details The hessian is only evaluated when @c refresh asks for a new factorization. A direction from an old
+	 * 			 factorization that is not of descent is discarded, and the hessian evaluated at the current point.
+	*/
 	template <class Function, class Hessian, class V>
 	V optimize (Function f, Hessian hess, V x)
 	{
 		impl::Scalar<V> fx;
-		V gx;
+		V gx, dir;
 
 		std::tie(fx, gx) = f(x);
 
+		refresh.initialize();
+
+		bool refreshed = true;
+
 		for(int iter = 0; iter < stop.maxIterations(); ++iter)
 		{
-			auto dir = factorization(gx, hess(x));
+			if(refreshed)
+				factorization.factorize(hess(x));
 
-			auto alpha = lineSearch(f, x, dir);
+			factorization.direction(gx, dir);
 
-			x = x + alpha * dir;
+			if(!refreshed && !(dir.dot(gx) < 0.0))
+			{
+				factorization.factorize(hess(x));
+				factorization.direction(gx, dir);
 
-			fx = f(x, gx);
+				refreshed = true;
+			}
+
+			auto gNorm = gx.norm();
+
+			auto alpha = lineSearch(f, x, dir, fx, gx);
+
+			x = x + alpha * dir;
 
 
 			if(stop(*this, x, fx, gx))
 				break;
 
+			refreshed = refresh(refreshed, gx.norm() / gNorm);
+
 			output(*this, x, fx, gx);
 		}
 
@@ -78,11 +156,11 @@ struct Newton : public params::Newton<Params_, Factorization>
 
 
 template <class Factorization = fact::SmallIdentity<>, class LineSearch = StrongWolfe<>,
-		class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<>>
-struct Newton : public impl::Newton<params::LineSearchOptimizer<LineSearch, Stop, Output>, Factorization>,
-                public GradientOptimizer<Newton<Factorization, LineSearch, Stop, Output>>
+		class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<>, class Refresh = newton::Always>
+struct Newton : public impl::Newton<params::LineSearchOptimizer<LineSearch, Stop, Output>, Factorization, Refresh>,
+                public GradientOptimizer<Newton<Factorization, LineSearch, Stop, Output, Refresh>>
 {
-   	CPPOPT_USING_PARAMS(Impl, impl::Newton<params::LineSearchOptimizer<LineSearch, Stop, Output>, Factorization>);
+   	CPPOPT_USING_PARAMS(Impl, impl::Newton<params::LineSearchOptimizer<LineSearch, Stop, Output>, Factorization, Refresh>);
 	using Impl::Impl;
 
 	template <class Function, class Hessian, class V>
@@ -102,10 +180,10 @@ struct Newton : public impl::Newton<params::LineSearchOptimizer<LineSearch, Stop
 namespace poly
 {
 
-template <class Factorization = ::nlpp::fact::SmallIdentity<>, class V = ::nlpp::Vec>
-struct Newton : public ::nlpp::impl::Newton<::nlpp::poly::GradientOptimizer<V>, Factorization>
+template <class Factorization = ::nlpp::fact::SmallIdentity<>, class V = ::nlpp::Vec, class Refresh = ::nlpp::newton::Always>
+struct Newton : public ::nlpp::impl::Newton<::nlpp::poly::GradientOptimizer<V>, Factorization, Refresh>
 {
-	CPPOPT_USING_PARAMS(Impl, ::nlpp::impl::Newton<::nlpp::poly::GradientOptimizer<V>, Factorization>);
+	CPPOPT_USING_PARAMS(Impl, ::nlpp::impl::Newton<::nlpp::poly::GradientOptimizer<V>, Factorization, Refresh>);
 	using Impl::Impl;
 
 	virtual V optimize (::nlpp::wrap::poly::FunctionGradient<V> f, ::nlpp::wrap::poly::Hessian<V> hess, V x)
@@ -0,0 +1,217 @@
+/** @file
+ *  @brief Truncated Newton (Newton-CG), needing only hessian vector products
+ *
+ *  @details The Newton system @f$\nabla^2 f(x_k) p = -\nabla f(x_k)@f$ is solved approximately by linear CG (algorithm
+ * 			 7.1 of NOCEDAL), stopping when the residual is below @f$\eta_k \|\nabla f(x_k)\|@f$. The forcing term
+ * 			 @f$\eta_k@f$ is the second choice of Eisenstat and Walker, so the solves are loose far from the solution
+ * 			 and tight near it, keeping the superlinear convergence of the Newton method. A direction of nonpositive
+ * 			 curvature stops CG with the last iterate, or with the steepest descent direction if it is the first one.
+ *
+ * 			 The hessian is never formed if the given functor has a product interface @c hessian(x, e). Without a
+ * 			 hessian, each product is a difference of the gradient (fd::GradientHessian), costing a single gradient
+ * 			 call. A functor returning the whole hessian is evaluated once per iteration and multiplied.
+*/
+
+#pragma once
+
+#include "../Helpers/Helpers.h"
+
+#include "../Helpers/Optimizer.h"
+
+#include "../LineSearch/StrongWolfe/StrongWolfe.h"
+
+
+#define CPPOPT_USING_PARAMS_TRUNCATED_NEWTON(...) CPPOPT_USING_PARAMS(__VA_ARGS__);		\
+												  using Params::eta0;					\
+												  using Params::etaMax;					\
+												  using Params::gamma;					\
+												  using Params::alpha;					\
+												  using Params::maxCGIterations;
+
+
+
+
+namespace nlpp
+{
+
+namespace impl
+{
+
+namespace params
+{
+
+template <class Params_>
+struct TruncatedNewton : public Params_
+{
+	CPPOPT_USING_PARAMS(Params, Params_);
+	using Params::Params;
+
+
+	types::Float eta0 = 0.5;				///< Forcing term of the first iteration
+
+	types::Float etaMax = 0.9;				///< Upper bound of the forcing terms
+
+	types::Float gamma = 0.9;				///< Factor of the ratio of gradient norms on the forcing term
+
+	types::Float alpha = 1.618033988749895;	///< Exponent of the ratio of gradient norms on the forcing term
+
+	int maxCGIterations = 0;				///< Maximum number of CG iterations per direction. If 0, the dimension is used
+};
+
+} // namespace params
+
+
+
+template <class Params_>
+struct TruncatedNewton : public params::TruncatedNewton<Params_>
+{
+	CPPOPT_USING_PARAMS_TRUNCATED_NEWTON(Params, params::TruncatedNewton<Params_>);
+	using Params::Params;
+
+
+	template <class Function, class Hessian, class V>
+	V optimize (Function f, Hessian hess, V x)
+	{
+		using Float = impl::Scalar<V>;
+
+		Float fx;
+		V gx, dir, r, d, hd;
+
+		std::tie(fx, gx) = f(x);
+
+		Float eta = eta0;
+
+		for(int iter = 0; iter < stop.maxIterations(); ++iter)
+		{
+			direction(::nlpp::wrap::hessianOperator(hess, x, gx), gx, eta, dir, r, d, hd);
+
+			Float gNorm = gx.norm();
+
+			auto step = lineSearch(f, x, dir, fx, gx);
+
+			x = x + step * dir;
+
+
+			if(stop(*this, x, fx, gx))
+				break;
+
+			eta = forcing(eta, gx.norm() / gNorm);
+
+			output(*this, x, fx, gx);
+		}
+
+		return x;
+	}
+
+
+	/** @brief Approximate solution of @f$H p = -g@f$ by CG, starting from @f$p = 0@f$
+	 *
+	 *  @param hx The hessian, or any operator giving the product @c hx * e (see wrap::hessianOperator)
+	 *  @param r,d,hd Residual, CG direction and its product with the hessian, given to avoid allocations
+	*/
+	template <class Hessian, class V, typename Float>
+	void direction (const Hessian& hx, const V& gx, Float eta, V& p, V& r, V& d, V& hd)
+	{
+		p.setZero(gx.rows(), gx.cols());
+
+		r = gx;
+		d = -gx;
+
+		Float rr = r.squaredNorm(), tol = eta * eta * rr;
+
+		int maxIter = maxCGIterations > 0 ? maxCGIterations : gx.size();
+
+		for(int iter = 0; iter < maxIter; ++iter)
+		{
+			hd = hx * d;
+
+			Float dhd = d.dot(hd);
+
+			/// Nonpositive curvature along d, so the quadratic model is not bounded
+			if(!(dhd > 0.0))
+			{
+				if(iter == 0)
+					p = -gx;
+
+				return;
+			}
+
+			Float a = rr / dhd;
+
+			p.noalias() += a * d;
+			r.noalias() += a * hd;
+
+			Float rrNew = r.squaredNorm();
+
+			if(rrNew <= tol)
+				return;
+
+			d = (rrNew / rr) * d - r;
+			rr = rrNew;
+		}
+	}
+
+	/// Second choice of Eisenstat and Walker, safeguarded against a fast decrease of the forcing terms
+	template <typename Float>
+	Float forcing (Float eta, Float ratio) const
+	{
+		Float next = gamma * std::pow(ratio, alpha), safe = gamma * std::pow(eta, alpha);
+
+		if(safe > 0.1)
+			next = std::max(next, safe);
+
+		return std::min<Float>(next, etaMax);
+	}
+};
+
+} // namespace impl
+
+
+template <class LineSearch = StrongWolfe<>, class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<>>
+struct TruncatedNewton : public impl::TruncatedNewton<params::LineSearchOptimizer<LineSearch, Stop, Output>>,
+						 public GradientOptimizer<TruncatedNewton<LineSearch, Stop, Output>>
+{
+	CPPOPT_USING_PARAMS(Impl, impl::TruncatedNewton<params::LineSearchOptimizer<LineSearch, Stop, Output>>);
+	using Impl::Impl;
+
+	template <class Function, class Hessian, class V>
+	V optimize (Function f, Hessian hess, V x)
+	{
+		return Impl::optimize(f, hess, x);
+	}
+
+	template <class Function, class V>
+	V optimize (Function f, V x)
+	{
+		return optimize(f, ::nlpp::fd::gradientHessian(f), x);
+	}
+};
+
+
+namespace poly
+{
+
+template <class V = ::nlpp::Vec>
+struct TruncatedNewton : public ::nlpp::impl::TruncatedNewton<::nlpp::poly::GradientOptimizer<V>>
+{
+	CPPOPT_USING_PARAMS(Impl, ::nlpp::impl::TruncatedNewton<::nlpp::poly::GradientOptimizer<V>>);
+	using Impl::Impl;
+
+	virtual V optimize (::nlpp::wrap::poly::FunctionGradient<V> f, ::nlpp::wrap::poly::Hessian<V> hess, V x)
+	{
+		return Impl::optimize(f, hess, x);
+	}
+
+	virtual V optimize (::nlpp::wrap::poly::FunctionGradient<V> f, V x)
+	{
+		return Impl::optimize(f, ::nlpp::fd::gradientHessian(f), x);
+	}
+
+
+	virtual TruncatedNewton* clone_impl () const { return new TruncatedNewton(*this); }
+};
+
+} // namespace poly
+
+
+} // namespace nlpp
@@ -10,7 +10,8 @@
 
 
 #define CPPOPT_USING_PARAMS_BFGS(...) CPPOPT_USING_PARAMS(__VA_ARGS__);  \
-									  using Params::initialHessian;	
+									  using Params::initialHessian;	\
+									  using Params::approximation;
 
 
 
@@ -24,29 +25,167 @@ template <typename Float = types::Float>
 struct BFGS_Diagonal;
 
 
+/// Representations of the dense BFGS matrix, each keeping it up to date with the pairs @f$(s, y)@f$
+namespace bfgs
+{
+
+/** @brief The inverse hessian @f$H@f$ itself, of which only the lower triangle is stored
+ * 
+ *  @details Directions are a symmetric matrix-vector product.
+*/
+template <typename Float = types::Float>
+struct Inverse
+{
+	/// @param h0 The initial inverse hessian
+	template <class M>
+	void init (const Eigen::MatrixBase<M>& h0)
+	{
+		hess = h0;
+		hy.resize(h0.rows());
+	}
+
+	template <class U, class W>
+	void update (const Eigen::MatrixBase<U>& s, const Eigen::MatrixBase<W>& y)
+	{
+		update(hess, s, y, hy);
+	}
+
+	/// Writes @f$-H \nabla f@f$ on @c dir
+	template <class V>
+	void direction (const V& gx, V& dir)
+	{
+		dir.noalias() = hess.template selfadjointView<Eigen::Lower>() * gx;
+		dir = -dir;
+	}
+
+
+	/** @brief In place inverse BFGS update, touching only the lower triangle of @c hess
+	 * 
+	 *  @details Expanding the product form, with @f$\rho = 1 / y^\intercal s@f$:
+	 * 
+	 *           @f$H \leftarrow H - \rho (H y s^\intercal + s y^\intercal H) + \rho (1 + \rho y^\intercal H y) s s^\intercal
+	 *           = H - (t s^\intercal + s t^\intercal)@f$, with @f$t = \rho H y - \frac{\rho}{2} (1 + \rho y^\intercal H y) s@f$
+	 * 
+	 *           So it costs a symmetric matrix-vector product and a symmetric rank two update, that is, @f$O(N^2)@f$.
+	 *  
+	 *  @param hy Buffer for @f$H y@f$
+	*/
+	template <class H, class U, class W, class V>
+	static void update (H& hess, const U& s, const W& y, V& hy)
+	{
+		Float rho = 1.0 / std::max(y.dot(s), constants::eps_<Float>);
+
+		hy.noalias() = hess.template selfadjointView<Eigen::Lower>() * y;
+
+		Float a = 0.5 * rho * (1.0 + rho * y.dot(hy));
+
+		hy = rho * hy - a * s;
+
+		hess.template selfadjointView<Eigen::Lower>().rankUpdate(s, hy, -1.0);
+	}
+
+
+	MatX<Float> hess;	///< Inverse hessian (lower triangle)
+	VecX<Float> hy;
+};
+
+
+/** @brief The Cholesky factor @f$L@f$ of the hessian @f$B = L L^\intercal@f$
+ * 
+ *  @details The update @f$B \leftarrow B + \frac{y y^\intercal}{y^\intercal s} - \frac{B s s^\intercal B}{s^\intercal B s}@f$ is
+ * 			 a rank one update followed by a rank one downdate of @f$L@f$, both @f$O(N^2)@f$. Directions are two triangular
+ * 			 solves. Pairs with @f$y^\intercal s \leq \epsilon y^\intercal y@f$ are skipped, so @f$B@f$ stays positive
+ * 			 definite. If the downdate still fails by round-off, @f$B@f$ is reset to @f$\frac{y^\intercal y}{y^\intercal s} I@f$.
+ * 
+ * 			 The factor is available through @c llt, so a trust region solver can reuse it instead of factorizing @f$B@f$.
+*/
+template <typename Float = types::Float>
+struct Cholesky
+{
+	/** @param h0 The initial inverse hessian, factorized and inverted once in @f$O(N^3)@f$. If it is not positive
+	 * 			  definite, @f$B@f$ starts as @f$I / \gamma@f$, with @f$\gamma@f$ the mean absolute diagonal of @c h0
+	*/
+	template <class M>
+	void init (const Eigen::MatrixBase<M>& h0)
+	{
+		llt.compute(h0);
+
+		if(llt.info() == Eigen::Success)
+			llt.compute(llt.solve(MatX<Float>::Identity(h0.rows(), h0.cols())));
+
+		if(llt.info() != Eigen::Success)
+		{
+			Float gamma = h0.diagonal().cwiseAbs().mean();
+
+			llt.compute((gamma > 0.0 ? 1.0 / gamma : 1.0) * MatX<Float>::Identity(h0.rows(), h0.cols()));
+		}
+
+		ls.resize(h0.rows());
+		bs.resize(h0.rows());
+	}
+
+	template <class U, class W>
+	void update (const Eigen::MatrixBase<U>& s, const Eigen::MatrixBase<W>& y)
+	{
+		Float ys = y.dot(s);
+
+		if(!(ys > constants::eps_<Float> * y.squaredNorm()))
+			return;
+
+		/// @f$B s = L (L^\intercal s)@f$
+		ls.noalias() = llt.matrixU() * s;
+		bs.noalias() = llt.matrixL() * ls;
+
+		llt.rankUpdate(y, 1.0 / ys);
+		llt.rankUpdate(bs, -1.0 / ls.squaredNorm());
+
+		if(llt.info() != Eigen::Success)
+			llt.compute((y.squaredNorm() / ys) * MatX<Float>::Identity(s.rows(), s.rows()));
+	}
+
+	/// Writes @f$-B^{-1} \nabla f@f$ on @c dir
+	template <class V>
+	void direction (const V& gx, V& dir)
+	{
+		dir = -gx;
+		llt.solveInPlace(dir);
+	}
+
+
+	Eigen::LLT<MatX<Float>> llt;	///< Factorization of the hessian
+
+	VecX<Float> ls;
+	VecX<Float> bs;
+};
+
+} // namespace bfgs
+
+
 namespace impl
 {
 
 namespace params
 {
 
-template <class Params_, class InitialHessian = BFGS_Diagonal<>>
+template <class Params_, class InitialHessian = BFGS_Diagonal<>, class Approximation = bfgs::Inverse<>>
 struct BFGS : public Params_
 {
     CPPOPT_USING_PARAMS(Params, Params_);
     using Params::Params;
 
     InitialHessian initialHessian;
+
+    Approximation approximation;
 };
 
 } // namespace params
 
 
 
-template <class Params_, class InitialHessian = BFGS_Constant<>>
-struct BFGS : public params::BFGS<Params_, InitialHessian>
+template <class Params_, class InitialHessian = BFGS_Constant<>, class Approximation = bfgs::Inverse<>>
+struct BFGS : public params::BFGS<Params_, InitialHessian, Approximation>
 {
-    CPPOPT_USING_PARAMS_BFGS(Params, params::BFGS<Params_, InitialHessian>);
+    CPPOPT_USING_PARAMS_BFGS(Params, params::BFGS<Params_, InitialHessian, Approximation>);
     using Params::Params;
 
 
@@ -55,56 +194,51 @@ struct BFGS : public params::BFGS<Params_, InitialHessian>
     {
         using Float = impl::Scalar<V>;
 
-        int rows = x0.rows(), cols = x0.cols(), size = rows * cols;
+        int rows = x0.rows(), cols = x0.cols();
 
-        impl::Plain2D<V> In = impl::Plain2D<V>::Identity(size, size);
+        approximation.init(initialHessian(f, x0));
 
-        auto hess = initialHessian(f, x0);
-
-        V x1, g0(rows, cols), g1(rows, cols), dir, s, y;
+        V x1(rows, cols), g0(rows, cols), g1(rows, cols), dir(rows, cols), s(rows, cols), y(rows, cols);
 
         Float f0 = f(x0, g0);
         Float f1;
 
         for(int iter = 0; iter < stop.maxIterations(); ++iter)
         {
-            dir = -hess * g0;
-
-            auto alpha = lineSearch(f, x0, dir);
+            approximation.direction(g0, dir);
 
-            x1 = x0 + alpha * dir;
+            auto alpha = lineSearch(f, x0, dir, f1, g1);
 
-            f1 = f(x1, g1);
+            x1.noalias() = x0 + alpha * dir;
 
-            s = x1 - x0;
-            y = g1 - g0;
+            s.noalias() = x1 - x0;
+            y.noalias() = g1 - g0;
 
             if(stop(*this, x1, f1, g1))
-                break;
-
+                return x1;
 
-            Float rho = 1.0 / std::max(y.dot(s), constants::eps_<Float>);
 
-            hess = (In - rho * s * y.transpose()) * hess * (In - rho * y * s.transpose()) + rho * s * s.transpose();
+            approximation.update(s, y);
 
-            x0 = x1;
-            g0 = g1;
+            x0.swap(x1);
+            g0.swap(g1);
+            f0 = f1;
 
-            output(*this, x1, f1, g1);
+            output(*this, x0, f0, g0);
         }
 
-        return x1;
+        return x0;
     }
 };
 
 } // namespace impl
 
 template <class InitialHessian = BFGS_Diagonal<>, class LineSearch = StrongWolfe<>,
-          class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<0>>
-struct BFGS : public impl::BFGS<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian>,
-			  public GradientOptimizer<BFGS<InitialHessian, LineSearch, Stop, Output>>
+          class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<0>, class Approximation = bfgs::Inverse<>>
+struct BFGS : public impl::BFGS<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian, Approximation>,
+			  public GradientOptimizer<BFGS<InitialHessian, LineSearch, Stop, Output, Approximation>>
 {
-    CPPOPT_USING_PARAMS(Impl, impl::BFGS<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian>);
+    CPPOPT_USING_PARAMS(Impl, impl::BFGS<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian, Approximation>);
     using Impl::Impl;
 
     template <class Function, class V>
@@ -118,10 +252,10 @@ struct BFGS : public impl::BFGS<params::LineSearchOptimizer<LineSearch, Stop, Ou
 namespace poly
 {
 
-template <class InitialHessian = BFGS_Constant<>, class V = ::nlpp::Vec>
-struct BFGS : public ::nlpp::impl::BFGS<::nlpp::poly::GradientOptimizer<V>, InitialHessian>
+template <class InitialHessian = BFGS_Constant<>, class V = ::nlpp::Vec, class Approximation = bfgs::Inverse<::nlpp::impl::Scalar<V>>>
+struct BFGS : public ::nlpp::impl::BFGS<::nlpp::poly::GradientOptimizer<V>, InitialHessian, Approximation>
 {
-	CPPOPT_USING_PARAMS(Impl, ::nlpp::impl::BFGS<::nlpp::poly::GradientOptimizer<V>, InitialHessian>);
+	CPPOPT_USING_PARAMS(Impl, ::nlpp::impl::BFGS<::nlpp::poly::GradientOptimizer<V>, InitialHessian, Approximation>);
 	using Impl::Impl;
 
 	virtual V optimize (::nlpp::wrap::poly::FunctionGradient<V> f, V x)
@@ -201,8 +335,8 @@ struct BFGS : public GradientOptimizer<1, Float>
     using Base::operator();
     using Base::finish;
 
-    template <class Params, class InitialHessian, class V>
-    void operator() (const ::nlpp::impl::params::BFGS<Params, InitialHessian>& optimizer,
+    template <class Params, class InitialHessian, class Approximation, class V>
+    void operator() (const ::nlpp::impl::params::BFGS<Params, InitialHessian, Approximation>& optimizer,
                      const Eigen::MatrixBase<V>& x, double fx, const Eigen::MatrixBase<V>& gx)
     {
         Base::operator()(optimizer, x, fx, gx);
@@ -4,6 +4,8 @@
 
 #include "../../Helpers/Optimizer.h"
 
+#include "../../Helpers/ThreadPool.h"
+
 #include "../../LineSearch/StrongWolfe/StrongWolfe.h"
 
 #include "../BFGS/BFGS.h"
@@ -11,12 +13,604 @@
 
 #define CPPOPT_USING_PARAMS_LBFGS(...) CPPOPT_USING_PARAMS(__VA_ARGS__);	\
                                        using Params::m;                     \
-                                       using Params::initialHessian;
+                                       using Params::initialHessian;        \
+                                       using Params::history;
 
 
 namespace nlpp
 {
 
+/// Storage of the L-BFGS correction pairs @f$(s_i, y_i)@f$ and the two loop recursion over them
+namespace lbfgs
+{
+
+/** @brief Correction pairs kept as columns of two contiguous @c N x @c m matrices, used as a circular buffer
+ * 
+ *  @details The @f$\rho_i = 1 / y_i^\intercal s_i@f$ are computed once, when the pair is inserted. Every buffer is
+ * 			 allocated by @c init, so updates and directions do no heap allocation.
+ * 
+ *  @tparam Float Type of the accumulators of the recursion
+ *  @tparam Storage Type of the stored pairs. A narrower type (such as @c float or @c Eigen::bfloat16) reduces the memory
+ * 					and bandwidth of the history, while every dot product and update is still done in @c Float
+*/
+template <typename Float = types::Float, typename Storage = Float>
+struct Ring
+{
+	void init (int n, int m)
+	{
+		S.resize(n, m);
+		Y.resize(n, m);
+		rho.resize(m);
+		alpha.resize(m);
+		rhoz.resize(m);
+		q.resize(n);
+		r.resize(n);
+
+		clear();
+	}
+
+	void clear ()
+	{
+		first = size = 0;
+	}
+
+
+	/// Insert a new pair, overwriting the oldest one if the buffer is full
+	template <class U, class W>
+	void update (const Eigen::MatrixBase<U>& s, const Eigen::MatrixBase<W>& y)
+	{
+		int j = col(size);
+
+		if(size < S.cols())
+			size++;
+
+		else
+			first = (first + 1) % S.cols();
+
+		S.col(j) = impl::cast<Storage>(s);
+		Y.col(j) = impl::cast<Storage>(y);
+
+		/// From the rounded pair, so the recursion is consistent with what is stored
+		rho(j) = 1.0 / impl::cast<Float>(Y.col(j)).dot(impl::cast<Float>(S.col(j)));
+	}
+
+	/// Two loop recursion, writing @f$-H \nabla f@f$ on @c dir. The initial hessian @c h is either a matrix or a scalar
+	template <class V, class H>
+	void direction (const V& gx, const H& h, V& dir)
+	{
+		q = -gx;
+
+		for(int i = size - 1; i >= 0; --i)
+		{
+			int j = col(i);
+
+			alpha(j) = rho(j) * impl::cast<Float>(S.col(j)).dot(q);
+
+			q.noalias() -= alpha(j) * impl::cast<Float>(Y.col(j));
+		}
+
+		dir.noalias() = h * q;
+
+		for(int i = 0; i < size; ++i)
+		{
+			int j = col(i);
+
+			Float beta = rho(j) * impl::cast<Float>(Y.col(j)).dot(dir);
+
+			dir.noalias() += (alpha(j) - beta) * impl::cast<Float>(S.col(j));
+		}
+	}
+
+	/** @brief The same recursion on the rows @c idx only, with @c dir set to zero on the others
+	 *
+	 *  @details The pairs are restricted to these rows, so their products are recomputed, and the ones without positive
+	 * 			 curvature on the subspace are skipped. Costs @c O(m |idx|) instead of @c O(m N).
+	*/
+	template <class V, class H>
+	void direction (const V& gx, const H& h, V& dir, const std::vector<int>& idx)
+	{
+		auto qz = q.head(idx.size());
+		auto dz = r.head(idx.size());
+
+		qz = -gx(idx);
+
+		for(int i = size - 1; i >= 0; --i)
+		{
+			int j = col(i);
+
+			Float sy = impl::cast<Float>(S.col(j)(idx)).dot(impl::cast<Float>(Y.col(j)(idx)));
+
+			rhoz(j) = sy > constants::eps_<Float> * impl::cast<Float>(Y.col(j)(idx)).squaredNorm() ? 1.0 / sy : 0.0;
+
+			alpha(j) = rhoz(j) * impl::cast<Float>(S.col(j)(idx)).dot(qz);
+
+			qz.noalias() -= alpha(j) * impl::cast<Float>(Y.col(j)(idx));
+		}
+
+		initial(h, idx, qz, dz);
+
+		for(int i = 0; i < size; ++i)
+		{
+			int j = col(i);
+
+			Float beta = rhoz(j) * impl::cast<Float>(Y.col(j)(idx)).dot(dz);
+
+			dz.noalias() += (alpha(j) - beta) * impl::cast<Float>(S.col(j)(idx));
+		}
+
+		dir.setZero();
+		dir(idx) = dz;
+	}
+
+	/// Initial hessian on the rows @c idx, for a scalar or a diagonal matrix
+	template <class Idx, class U>
+	static void initial (Float h, const Idx&, const U& qz, U& dz)
+	{
+		dz = h * qz;
+	}
+
+	template <class D, class Idx, class U>
+	static void initial (const Eigen::DiagonalBase<D>& h, const Idx& idx, const U& qz, U& dz)
+	{
+		dz = h.diagonal()(idx).cwiseProduct(qz);
+	}
+
+
+	/// Column of the @c i-th pair, from the oldest (@c 0) to the newest (@c size - 1)
+	int col (int i) const
+	{
+		return (first + i) % S.cols();
+	}
+
+
+	MatX<Storage> S;	///< Steps @f$s_i = x_{i+1} - x_i@f$
+	MatX<Storage> Y;	///< Gradient differences @f$y_i = \nabla f_{i+1} - \nabla f_i@f$
+
+	VecX<Float> rho;
+	VecX<Float> alpha;
+	VecX<Float> q;
+
+	VecX<Float> rhoz;	///< The @f$\rho_i@f$ on the rows of a subspace
+	VecX<Float> r;
+
+	int first = 0;		///< Column of the oldest pair
+	int size = 0;		///< Number of stored pairs
+};
+
+
+/** @brief Compact representation of the L-BFGS matrices (Byrd, Nocedal and Schnabel)
+ * 
+ *  @details The pairs are kept as the columns of a single @c N x @c 2m matrix @f$W = [S \ Y]@f$, used as a circular
+ * 			 buffer, along with the small products @f$S^\intercal S@f$, @f$S^\intercal Y@f$ and @f$Y^\intercal Y@f$. With
+ * 			 @f$R@f$ the upper triangle of @f$S^\intercal Y@f$ and @f$D@f$ its diagonal, the inverse hessian is:
+ * 
+ * 			 @f$H = \gamma I + [S \ \gamma Y] \begin{bmatrix} R^{-\intercal} (D + \gamma Y^\intercal Y) R^{-1} & -R^{-\intercal} \\
+ * 			 -R^{-1} & 0 \end{bmatrix} [S \ \gamma Y]^\intercal@f$
+ * 
+ * 			 So a direction costs two passes over the history (@f$W^\intercal g@f$ and @f$W c@f$) plus @c m x @c m triangular
+ * 			 solves, instead of the @c 4m dependent dots and axpys of the two loop recursion. These two products are split
+ * 			 by blocks of rows among @c numThreads threads.
+ * 
+ * 			 The initial inverse hessian must be a scalar @f$\gamma@f$ (as in @c LBFGS_Scaling). The hessian itself can
+ * 			 also be applied to a vector with @c product, for trust region methods.
+*/
+template <typename Float = types::Float>
+struct Compact
+{
+	Compact (int numThreads = 1) : pool(numThreads > 1 ? std::make_shared<impl::ThreadPool>(numThreads) : nullptr)
+	{
+	}
+
+
+	void init (int n, int m)
+	{
+		W = MatX<Float>::Zero(n, 2 * m);
+
+		SS.resize(m, m);
+		SY.resize(m, m);
+		YY.resize(m, m);
+
+		R.resize(m, m);
+		N.resize(2 * m, 2 * m);
+
+		p.resize(2 * m);
+		c.resize(2 * m);
+		u.resize(m);
+		w.resize(m);
+
+		partial.resize(2 * m, pool ? pool->size() : 1);
+
+		clear();
+	}
+
+	void clear ()
+	{
+		first = size = 0;
+		factored = false;
+	}
+
+
+	/// Insert a new pair, overwriting the oldest one, and update the products with the other pairs
+	template <class U, class V>
+	void update (const Eigen::MatrixBase<U>& s, const Eigen::MatrixBase<V>& y)
+	{
+		int m = SY.rows(), j = col(size);
+
+		if(size < m)
+			size++;
+
+		else
+			first = (first + 1) % m;
+
+		W.col(j) = s;
+		W.col(m + j) = y;
+
+		factored = false;
+
+		multiplyTranspose(W.col(j), p);
+
+		SS.col(j) = p.head(m);
+		SS.row(j) = p.head(m).transpose();
+		SY.row(j) = p.tail(m).transpose();
+
+		multiplyTranspose(W.col(m + j), p);
+
+		SY.col(j) = p.head(m);
+		YY.col(j) = p.tail(m);
+		YY.row(j) = p.tail(m).transpose();
+	}
+
+	/// Write @f$-H \nabla f@f$ on @c dir, where the initial inverse hessian is @f$\gamma I@f$
+	template <class V>
+	void direction (const V& gx, Float gamma, V& dir)
+	{
+		int m = SY.rows();
+
+		multiplyTranspose(gx, p);
+
+		/// Chronological order for the triangular factors
+		for(int a = 0; a < size; ++a)
+		{
+			u(a) = p(col(a));
+			w(a) = p(m + col(a));
+
+			for(int b = 0; b < size; ++b)
+				R(a, b) = SY(col(a), col(b));
+		}
+
+		auto Rk = R.topLeftCorner(size, size).template triangularView<Eigen::Upper>();
+		auto uk = u.head(size);
+		auto wk = w.head(size);
+
+		Rk.solveInPlace(uk);
+
+		/// w = R^-T ((D + gamma Y'Y) u - gamma Y'g)
+		for(int a = 0; a < size; ++a)
+		{
+			Float t = R(a, a) * uk(a) - gamma * wk(a);
+
+			for(int b = 0; b < size; ++b)
+				t += gamma * YY(col(a), col(b)) * uk(b);
+
+			p(a) = t;
+		}
+
+		wk = p.head(size);
+
+		Rk.transpose().solveInPlace(wk);
+
+		c.setZero();
+
+		for(int a = 0; a < size; ++a)
+		{
+			c(col(a)) = wk(a);
+			c(m + col(a)) = -gamma * uk(a);
+		}
+
+		multiply(c, dir);
+
+		dir = -gamma * gx - dir;
+	}
+
+	/** @brief Write @f$B v@f$ on @c out, where @f$B = H^{-1}@f$ is the L-BFGS hessian with initial hessian @f$I / \gamma@f$
+	 * 
+	 *  @details @f$B = \sigma I - [\sigma S \ Y] \begin{bmatrix} \sigma S^\intercal S & L \\ L^\intercal & -D \end{bmatrix}^{-1}
+	 * 			 [\sigma S \ Y]^\intercal@f$, with @f$\sigma = 1 / \gamma@f$ and @f$L@f$ the strict lower triangle of
+	 * 			 @f$S^\intercal Y@f$. The middle matrix is factorized once per update (and value of @f$\gamma@f$), so
+	 * 			 the products of a trust region iteration share it.
+	*/
+	template <class V>
+	void product (const V& v, Float gamma, V& out)
+	{
+		int m = SY.rows();
+		Float sigma = 1.0 / gamma;
+
+		if(!factored || sigma != factoredSigma)
+			factorize(sigma);
+
+		multiplyTranspose(v, p);
+
+		for(int a = 0; a < size; ++a)
+		{
+			c(a) = sigma * p(col(a));
+			c(size + a) = p(m + col(a));
+		}
+
+		p.head(2 * size) = lu.solve(c.head(2 * size));
+
+		c.setZero();
+
+		for(int a = 0; a < size; ++a)
+		{
+			c(col(a)) = sigma * p(a);
+			c(m + col(a)) = p(size + a);
+		}
+
+		multiply(c, out);
+
+		out = sigma * v - out;
+	}
+
+
+	/// LU factorization of the middle matrix of @c product, in chronological order
+	void factorize (Float sigma)
+	{
+		for(int a = 0; a < size; ++a)
+		{
+			for(int b = 0; b < size; ++b)
+			{
+				N(a, b) = sigma * SS(col(a), col(b));
+				N(a, size + b) = a > b ? SY(col(a), col(b)) : 0.0;
+				N(size + b, a) = N(a, size + b);
+				N(size + a, size + b) = a == b ? -SY(col(a), col(a)) : 0.0;
+			}
+		}
+
+		lu.compute(N.topLeftCorner(2 * size, 2 * size));
+
+		factored = true;
+		factoredSigma = sigma;
+	}
+
+
+	/// Column of the @c i-th pair of @c S, from the oldest (@c 0) to the newest (@c size - 1)
+	int col (int i) const
+	{
+		return (first + i) % SY.rows();
+	}
+
+	/// @c out = @f$W^\intercal v@f$, summing the products of each block of rows
+	template <class V>
+	void multiplyTranspose (const V& v, VecX<Float>& out)
+	{
+		if(!pool)
+			out.noalias() = W.transpose() * v;
+
+		else
+		{
+			int n = W.rows(), numBlocks = pool->size();
+
+			pool->run(numBlocks, [&](int b)
+			{
+				int begin = (b * n) / numBlocks, end = ((b + 1) * n) / numBlocks;
+
+				partial.col(b).noalias() = W.middleRows(begin, end - begin).transpose() * v.segment(begin, end - begin);
+			});
+
+			out = partial.rowwise().sum();
+		}
+	}
+
+	/// @c out = @f$W c@f$, each block of rows in a different thread
+	template <class V>
+	void multiply (const VecX<Float>& c, V& out)
+	{
+		if(!pool)
+			out.noalias() = W * c;
+
+		else
+		{
+			int n = W.rows(), numBlocks = pool->size();
+
+			pool->run(numBlocks, [&](int b)
+			{
+				int begin = (b * n) / numBlocks, end = ((b + 1) * n) / numBlocks;
+
+				out.segment(begin, end - begin).noalias() = W.middleRows(begin, end - begin) * c;
+			});
+		}
+	}
+
+
+	MatX<Float> W;			///< Steps and gradient differences @f$[S \ Y]@f$, in the order of the circular buffer
+
+	MatX<Float> SS;			///< @f$S^\intercal S@f$
+	MatX<Float> SY;			///< @f$S^\intercal Y@f$
+	MatX<Float> YY;			///< @f$Y^\intercal Y@f$
+
+	MatX<Float> R;
+	MatX<Float> N;
+	Eigen::PartialPivLU<MatX<Float>> lu;
+
+	VecX<Float> p;
+	VecX<Float> c;
+	VecX<Float> u;
+	VecX<Float> w;
+	MatX<Float> partial;
+
+	int first = 0;			///< Column of the oldest pair
+	int size = 0;			///< Number of stored pairs
+
+	bool factored = false;	///< If @c lu holds the middle matrix of the current pairs
+	Float factoredSigma = 0.0;
+
+	std::shared_ptr<impl::ThreadPool> pool;
+};
+
+
+/// Correction pairs kept in double ended queues. Allocates new vectors on every update and direction
+template <typename Float = types::Float>
+struct Deque
+{
+	void init (int, int m)
+	{
+		this->m = m;
+
+		clear();
+	}
+
+	void clear ()
+	{
+		vs.clear();
+		vy.clear();
+	}
+
+
+	template <class U, class W>
+	void update (const Eigen::MatrixBase<U>& s, const Eigen::MatrixBase<W>& y)
+	{
+		vs.emplace_back(s);
+		vy.emplace_back(y);
+
+		if(vs.size() > m)
+		{
+			vs.pop_front();
+			vy.pop_front();
+		}
+	}
+
+	template <class V, class H>
+	void direction (const V& gx, const H& h, V& dir)
+	{
+		V alpha(vs.size());
+		V rho(vs.size());
+		V q = -gx;
+
+		for(int i = vs.size() - 1; i >= 0; --i)
+		{
+			rho[i] = 1.0 / vy[i].dot(vs[i]);
+			alpha[i] = rho[i] * vs[i].dot(q);
+
+			q = q - alpha[i] * vy[i];
+		}
+
+		V r = h * q;
+
+		for(int i = 0; i < vs.size(); ++i)
+		{
+			auto beta = rho[i] * vy[i].dot(r);
+
+			r = r + (alpha[i] - beta) * vs[i];
+		}
+
+		dir = r;
+	}
+
+
+	std::deque<VecX<Float>> vs;
+	std::deque<VecX<Float>> vy;
+
+	std::size_t m;
+};
+
+} // namespace lbfgs
+
+
+
+/** @brief Initial inverse hessian @f$\gamma I@f$, with @f$\gamma = s^\intercal y / y^\intercal y@f$ of the newest pair
+ * 
+ *  @details Costs no evaluation at all. Before the first pair is known, @f$\gamma = \gamma_0 / \|\nabla f(x_0)\|@f$, so the
+ * 			 first trial step has length @f$\gamma_0@f$.
+*/
+template <typename Float = types::Float>
+struct LBFGS_Scaling
+{
+    LBFGS_Scaling (Float gamma0 = 1.0) : gamma0(gamma0), gamma(gamma0) {}
+
+
+    template <class V>
+    void init (const Eigen::MatrixBase<V>& gx)
+    {
+        gamma = gamma0 / std::max(gx.norm(), constants::eps_<Float>);
+    }
+
+    template <class U, class W>
+    void update (const Eigen::MatrixBase<U>& s, const Eigen::MatrixBase<W>& y)
+    {
+        Float sy = s.dot(y), yy = y.squaredNorm();
+
+        /// Relative to the size of y, so pairs near the solution still update the scaling
+        if(sy > constants::eps_<Float> * yy)
+            gamma = sy / yy;
+    }
+
+    template <class Function, class V>
+    Float operator () (Function, const V&) const
+    {
+        return gamma;
+    }
+
+
+    Float gamma0;
+    Float gamma;
+};
+
+
+/** @brief Diagonal initial inverse hessian, updated with the diagonal of the inverse BFGS update (Gilbert-Lemarechal)
+ * 
+ *  @details Starts from the same @f$\gamma I@f$ as @c LBFGS_Scaling. Then, for each new pair:
+ * 
+ * 			 @f$D_{i} \leftarrow D_i + \left(1 + \frac{y^\intercal D y}{s^\intercal y}\right) \frac{s_i^2}{s^\intercal y}
+ * 			 - 2 \frac{D_i y_i s_i}{s^\intercal y}@f$
+ * 
+ * 			 which stays positive as long as @f$s^\intercal y > 0@f$. Also costs no evaluation, and scales each variable
+ * 			 independently.
+*/
+template <typename Float = types::Float>
+struct LBFGS_DiagonalScaling
+{
+    LBFGS_DiagonalScaling (Float gamma0 = 1.0) : gamma0(gamma0) {}
+
+
+    template <class V>
+    void init (const Eigen::MatrixBase<V>& gx)
+    {
+        d = VecX<Float>::Constant(gx.size(), gamma0 / std::max(gx.norm(), constants::eps_<Float>));
+        first = true;
+    }
+
+    template <class U, class W>
+    void update (const Eigen::MatrixBase<U>& s, const Eigen::MatrixBase<W>& y)
+    {
+        Float sy = s.dot(y), yy = y.squaredNorm();
+
+        if(!(sy > constants::eps_<Float> * yy))
+            return;
+
+        if(first)
+            d.setConstant(sy / yy), first = false;
+
+        Float yDy = (y.array().square() * d.array()).sum();
+
+        d.array() += ((1.0 + yDy / sy) * s.array().square() - 2.0 * d.array() * y.array() * s.array()) / sy;
+    }
+
+    template <class Function, class V>
+    auto operator () (Function, const V&) const
+    {
+        return d.asDiagonal();
+    }
+
+
+    Float gamma0;
+
+    VecX<Float> d;
+
+    bool first = true;
+};
+
+
+
 namespace impl
 {
 
@@ -24,7 +618,7 @@ namespace params
 {
 
 
-template <class Params_, class InitialHessian = BFGS_Diagonal<>>
+template <class Params_, class InitialHessian = LBFGS_Scaling<>, class History = lbfgs::Ring<>>
 struct LBFGS : public Params_
 {
 	CPPOPT_USING_PARAMS(Params, Params_);
@@ -34,15 +628,17 @@ struct LBFGS : public Params_
 	int m = 10;
 
     InitialHessian initialHessian;
+
+	History history;
 };
 
 } // namespace params
 
 
-template <class Params_, class InitialHessian = BFGS_Diagonal<>>
-struct LBFGS : public params::LBFGS<Params_, InitialHessian>
+template <class Params_, class InitialHessian = LBFGS_Scaling<>, class History = lbfgs::Ring<>>
+struct LBFGS : public params::LBFGS<Params_, InitialHessian, History>
 {
-    CPPOPT_USING_PARAMS_BFGS(Params, params::LBFGS<Params_, InitialHessian>);
+    CPPOPT_USING_PARAMS_LBFGS(Params, params::LBFGS<Params_, InitialHessian, History>);
     using Params::Params;
 
 
@@ -51,89 +647,81 @@ struct LBFGS : public params::LBFGS<Params_, InitialHessian>
 	{
         using Float = impl::Scalar<V>;
 
+        V x(x0.rows(), x0.cols()), p(x0.rows(), x0.cols());
         V gx(x0.rows(), x0.cols()), gx0(x0.rows(), x0.cols());
         Float fx0, fx;
 
         fx0 = f(x0, gx0);
-        
-        std::deque<V> vs;
-        std::deque<V> vy;
+
+        history.init(x0.size(), m);
+
+        initHessian(gx0, Precedence<0>{});
 
         for(int iter = 0; iter < stop.maxIterations(); ++iter)
         {
             auto H = initialHessian(f, x0);
 
-            V p = direction(f, x0, gx0, H, vs, vy);
+            history.direction(gx0, H, p);
 
-            auto alpha = lineSearch(f, x0, p);
+            auto alpha = lineSearch(f, x0, p, fx, gx);
 
-            V x = x0 + alpha * p;
-
-            fx = f(x, gx);
+            x.noalias() = x0 + alpha * p;
 
             if(stop(*this, x, fx, gx))
                 return x;
 
-            auto s = x - x0;
-            auto y = gx - gx0;
-
-            vs.push_back(s);
-            vy.push_back(y);
-
-            if(iter > std::min(Params::m, (int)x0.size()))
+            /// A pair without positive curvature would make the two loop recursion indefinite, so it is skipped
+            if((x - x0).dot(gx - gx0) > constants::eps_<Float> * (gx - gx0).squaredNorm())
             {
-                vs.pop_front();
-                vy.pop_front();
+                history.update(x - x0, gx - gx0);
+
+                updateHessian(x - x0, gx - gx0, Precedence<0>{});
             }
 
-            std::tie(x0, fx0, gx0) = std::tie(x, fx, gx);
+            x0.swap(x);
+            gx0.swap(gx);
+            fx0 = fx;
 
-            output(*this, x, fx, gx);
+            output(*this, x0, fx0, gx0);
         }
 
         return x0;
 	}
 
 
-    template <class Function, class V, class U>
-    V direction (Function f, const V& x, const V& gx, const Eigen::MatrixBase<U>& H,
-                 const std::deque<V>& vs, const std::deque<V>& vy)
+    /// Only for initial hessians learning from the correction pairs, such as @c LBFGS_Scaling
+    //@{
+    template <class V, class IH = InitialHessian>
+    auto initHessian (const V& gx, Precedence<0>) -> decltype(std::declval<IH&>().init(gx), void())
     {
-        V alpha(vs.size());
-        V rho(vs.size());
-        V q = -gx;
-
-        for(int i = vs.size() - 1; i >= 0; --i)
-        {
-            rho[i] = 1.0 / vy[i].dot(vs[i]);
-            alpha[i] = rho[i] * vs[i].dot(q);
-
-            q = q - alpha[i] * vy[i];
-        }
+        initialHessian.init(gx);
+    }
 
-        V r = H * q;
+    template <class V>
+    void initHessian (const V&, Precedence<1>) {}
 
-        for(int i = 0; i < vs.size(); ++i)
-        {
-            auto beta = rho[i] * vy[i].dot(r);
 
-            r = r + (alpha[i] - beta) * vs[i];
-        }
-
-        return r;
+    template <class U, class W, class IH = InitialHessian>
+    auto updateHessian (const U& s, const W& y, Precedence<0>) -> decltype(std::declval<IH&>().update(s, y), void())
+    {
+        initialHessian.update(s, y);
     }
+
+    template <class U, class W>
+    void updateHessian (const U&, const W&, Precedence<1>) {}
+    //@}
 };
 
 } // namespace impl
 
 
 
-template <class InitialHessian = BFGS_Diagonal<>, class LineSearch = StrongWolfe<>,
-          class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<0>>
-struct LBFGS : public impl::LBFGS<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian>,
-			   public GradientOptimizer<LBFGS<InitialHessian, LineSearch, Stop, Output>>
+template <class InitialHessian = LBFGS_Scaling<>, class LineSearch = StrongWolfe<>,
+          class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<0>, class History = lbfgs::Ring<>>
+struct LBFGS : public impl::LBFGS<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian, History>,
+			   public GradientOptimizer<LBFGS<InitialHessian, LineSearch, Stop, Output, History>>
 {
-    CPPOPT_USING_PARAMS(Impl, impl::LBFGS<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian>);
+    CPPOPT_USING_PARAMS(Impl, impl::LBFGS<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian, History>);
     using Impl::Impl;
 
     template <class Function, class V>
@@ -147,10 +735,10 @@ struct LBFGS : public impl::LBFGS<params::LineSearchOptimizer<LineSearch, Stop,
 namespace poly
 {
 
-template <class InitialHessian = BFGS_Constant<>, class V = ::nlpp::Vec>
-struct LBFGS : public ::nlpp::impl::LBFGS<::nlpp::poly::GradientOptimizer<V>, InitialHessian>
+template <class InitialHessian = LBFGS_Scaling<>, class V = ::nlpp::Vec, class History = lbfgs::Ring<::nlpp::impl::Scalar<V>>>
+struct LBFGS : public ::nlpp::impl::LBFGS<::nlpp::poly::GradientOptimizer<V>, InitialHessian, History>
 {
-	CPPOPT_USING_PARAMS(Impl, ::nlpp::impl::LBFGS<::nlpp::poly::GradientOptimizer<V>, InitialHessian>);
+	CPPOPT_USING_PARAMS(Impl, ::nlpp::impl::LBFGS<::nlpp::poly::GradientOptimizer<V>, InitialHessian, History>);
 	using Impl::Impl;
 
 	virtual V optimize (::nlpp::wrap::poly::FunctionGradient<V> f, V x)
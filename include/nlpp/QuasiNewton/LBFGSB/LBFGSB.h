@@ -0,0 +1,480 @@
+/** @file
+
+    @brief L-BFGS-B (Byrd, Lu, Nocedal and Zhu), for @f$\min f(x)@f$ subject to @f$l \leq x \leq u@f$
+
+    @details Each iteration has three steps, all using the compact representation of the L-BFGS hessian
+             @f$B = \theta I - W M W^\intercal@f$, with @f$W = [Y \ \theta S]@f$ and @f$\theta = 1 / \gamma@f$:
+
+             - Generalized Cauchy point: the first local minimizer of the quadratic model along the projected steepest
+               descent path @f$\pi(x - t \nabla f)@f$. The variables at their bounds there are fixed.
+             - Subspace minimization: the quadratic model is minimized over the free variables, with the
+               Sherman-Morrison-Woodbury formula, and the step is truncated to stay in the box.
+             - Projected line search along the direction to this point.
+
+             Every operation with @c B costs @c O(mN), plus @c O(m^2) for each breakpoint of the Cauchy search. The
+             pairs are kept in a @c lbfgs::Compact, so the history must be of this type.
+**/
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+#include "../LBFGS/LBFGS.h"
+
+
+namespace nlpp
+{
+
+namespace lbfgsb
+{
+
+/** @brief Backtracking on the projected arc @f$x(a) = \pi(x + a p)@f$
+ *
+ *  @details Accepts the first step satisfying @f$f(x(a)) \leq f(x) + c \nabla f(x)^\intercal (x(a) - x)@f$. Starting
+ * 			 from @c a0 = 1, every trial point is already in the box when @c p points to a feasible point.
+*/
+template <typename Float = types::Float>
+struct Backtracking
+{
+	Backtracking (Float a0 = 1.0, Float c = 1e-4, Float rho = 0.5, Float aMin = constants::eps_<Float>) :
+				  a0(a0), c(c), rho(rho), aMin(aMin)
+	{
+		assert(c < 1.0 && "c must be smaller than 1.0");
+		assert(rho < 1.0 && "rho must be smaller than 1.0");
+	}
+
+	void initialize () {}
+
+
+	/// Returns the accepted step, writing the point on @c x, its gradient on @c gx and its value on @c fx
+	template <class Function, class V>
+	Float operator () (Function f, const V& lower, const V& upper, const V& x0, Float fx0, const V& gx0, const V& p,
+					   V& x, V& gx, Float& fx)
+	{
+		Float a = a0;
+
+		while(true)
+		{
+			x = (x0 + a * p).cwiseMax(lower).cwiseMin(upper);
+
+			fx = f(x, gx);
+
+			if(fx <= fx0 + c * gx0.dot(x - x0) || a < aMin)
+				return a;
+
+			a = rho * a;
+		}
+	}
+
+
+	Float a0;		///< Initial step
+
+	Float c;		///< Factor of the sufficient decrease condition
+
+	Float rho;		///< Factor to reduce @c a
+
+	Float aMin;		///< Smallest step acceptable
+};
+
+} // namespace lbfgsb
+
+
+namespace impl
+{
+
+namespace params
+{
+
+template <class Params_, typename Float = types::Float>
+struct LBFGSB : public Params_
+{
+	CPPOPT_USING_PARAMS(Params, Params_);
+	using Params::Params;
+
+
+	/// Bounds of the variables. If empty, there is no bound on this side
+	//@{
+	VecX<Float> lower;
+	VecX<Float> upper;
+	//@}
+};
+
+} // namespace params
+
+
+/** @brief The L-BFGS-B optimizer
+ *
+ *  @tparam Float Scalar of the bounds and of the work buffers, which must be the scalar of the variables
+ *  @tparam History A @c lbfgs::Compact of the same scalar
+*/
+template <class Params_, class InitialHessian = LBFGS_Scaling<>, typename Float = types::Float, class History = lbfgs::Compact<Float>>
+struct LBFGSB : public LBFGS<params::LBFGSB<Params_, Float>, InitialHessian, History>
+{
+    CPPOPT_USING_PARAMS_LBFGS(Params, LBFGS<params::LBFGSB<Params_, Float>, InitialHessian, History>);
+    using Params::Params;
+    using Params::lower;
+    using Params::upper;
+    using Params::initHessian;
+    using Params::updateHessian;
+
+
+	template <class Function, class V>
+	V optimize (Function f, V x0)
+	{
+        static_assert(std::is_same<impl::Scalar<V>, Float>::value, "The variables must have the scalar of the bounds");
+
+        int n = x0.size();
+
+        V l = lower.size() ? V(lower) : V::Constant(n, -std::numeric_limits<Float>::infinity());
+        V u = upper.size() ? V(upper) : V::Constant(n, std::numeric_limits<Float>::infinity());
+
+        V x(n), gx(n), gx0(n), pg(n), pg0(n), xc(n), dir(n);
+        Float fx0, fx;
+
+        init(n);
+
+        x0 = x0.cwiseMax(l).cwiseMin(u);
+
+        fx0 = f(x0, gx0);
+
+        history.init(n, m);
+
+        initHessian(gx0, Precedence<0>{});
+
+        projectedGradient(x0, gx0, l, u, pg0);
+
+        for(int iter = 0; iter < stop.maxIterations(); ++iter)
+        {
+            Float theta = 1.0 / initialHessian(f, x0);
+
+            middleMatrix(theta);
+
+            cauchyPoint(x0, gx0, l, u, theta, xc);
+
+            subspaceMinimization(x0, gx0, l, u, theta, xc);
+
+            dir = xc - x0;
+
+            /// Only by round-off, with a nearly singular middle matrix. Restart from the projected steepest descent
+            if(dir.dot(gx0) >= 0.0)
+            {
+                history.clear();
+                dir = pg0;
+            }
+
+            lineSearch(f, l, u, x0, fx0, gx0, dir, x, gx, fx);
+
+            projectedGradient(x, gx, l, u, pg);
+
+            if(stop(*this, x, fx, pg))
+                return x;
+
+            /// Without a curvature condition on the line search, pairs must be checked to keep the matrix positive definite
+            if((x - x0).dot(gx - gx0) > constants::eps_<Float> * (gx - gx0).squaredNorm())
+            {
+                history.update(x - x0, gx - gx0);
+
+                updateHessian(x - x0, gx - gx0, Precedence<0>{});
+            }
+
+            x0.swap(x);
+            gx0.swap(gx);
+            pg0.swap(pg);
+            fx0 = fx;
+
+            output(*this, x0, fx0, pg0);
+        }
+
+        return x0;
+	}
+
+
+    /// @f$\pi(x - \nabla f) - x@f$, which is zero at a stationary point of the bounded problem
+    template <class V>
+    static void projectedGradient (const V& x, const V& gx, const V& l, const V& u, V& pg)
+    {
+        pg = (x - gx).cwiseMax(l).cwiseMin(u) - x;
+    }
+
+
+    void init (int n)
+    {
+        Wb.resize(n, 2 * m);
+        WZ.resize(n, 2 * m);
+        K.resize(2 * m, 2 * m);
+        N.resize(2 * m, 2 * m);
+
+        p.resize(2 * m);
+        c.resize(2 * m);
+        v.resize(2 * m);
+        Mc.resize(2 * m);
+        Mp.resize(2 * m);
+        Mw.resize(2 * m);
+
+        t.resize(n);
+        d.resize(n);
+        r.resize(n);
+
+        order.reserve(n);
+        free.reserve(n);
+    }
+
+    /// Chronological @f$W = [Y \ \theta S]@f$ and the factorization of @f$M^{-1} = \begin{bmatrix} -D & L^\intercal \\ L & \theta S^\intercal S \end{bmatrix}@f$
+    void middleMatrix (Float theta)
+    {
+        int k = history.size, mm = history.SY.rows();
+
+        for(int a = 0; a < k; ++a)
+        {
+            int i = history.col(a);
+
+            Wb.col(a) = history.W.col(mm + i);
+            Wb.col(k + a) = theta * history.W.col(i);
+
+            for(int b = 0; b < k; ++b)
+            {
+                int j = history.col(b);
+
+                K(a, b) = a == b ? -history.SY(i, i) : 0.0;
+                K(k + a, b) = a > b ? history.SY(i, j) : 0.0;
+                K(b, k + a) = K(k + a, b);
+                K(k + a, k + b) = theta * history.SS(i, j);
+            }
+        }
+
+        if(k)
+            lu.compute(K.topLeftCorner(2 * k, 2 * k));
+    }
+
+    /** @brief Generalized Cauchy point, written on @c xc
+     *
+     *  @details Walks over the breakpoints of the projected path in increasing order, keeping the first and second
+     * 			 derivatives of the model along the current segment up to date in @c O(m^2) per breakpoint. At the
+     * 			 end, @c c holds @f$W^\intercal (x^c - x)@f$.
+    */
+    template <class V>
+    void cauchyPoint (const V& x, const V& gx, const V& l, const V& u, Float theta, V& xc)
+    {
+        int n = x.size(), k2 = 2 * history.size;
+
+        auto pk = p.head(k2);
+        auto ck = c.head(k2);
+
+        order.clear();
+
+        for(int i = 0; i < n; ++i)
+        {
+            if(gx(i) < 0.0)
+                t(i) = (x(i) - u(i)) / gx(i);
+
+            else if(gx(i) > 0.0)
+                t(i) = (x(i) - l(i)) / gx(i);
+
+            else
+                t(i) = std::numeric_limits<Float>::infinity();
+
+            d(i) = t(i) == 0.0 ? 0.0 : -gx(i);
+
+            if(t(i) > 0.0 && t(i) < std::numeric_limits<Float>::infinity())
+                order.push_back(i);
+        }
+
+        std::sort(order.begin(), order.end(), [&](int i, int j){ return t(i) < t(j); });
+
+        xc = x;
+        ck.setZero();
+        pk.noalias() = Wb.leftCols(k2).transpose() * d;
+
+        Float fp = -d.squaredNorm();
+        Float fpp = -theta * fp, fpp0 = fpp;
+
+        if(fp >= 0.0)
+            return;
+
+        if(k2)
+            fpp -= pk.dot(lu.solve(pk));
+
+        Float dtMin = -fp / fpp, tOld = 0.0;
+
+        std::size_t idx = 0;
+
+        for(; idx < order.size(); ++idx)
+        {
+            int b = order[idx];
+
+            Float dt = t(b) - tOld;
+
+            if(dtMin < dt)
+                break;
+
+            xc(b) = d(b) > 0.0 ? u(b) : l(b);
+
+            Float zb = xc(b) - x(b), gb = gx(b);
+
+            ck += dt * pk;
+
+            fp += dt * fpp + gb * gb + theta * gb * zb;
+            fpp -= theta * gb * gb;
+
+            if(k2)
+            {
+                auto wb = Wb.row(b).head(k2).transpose();
+
+                Mc.head(k2) = lu.solve(ck);
+                Mp.head(k2) = lu.solve(pk);
+                Mw.head(k2) = lu.solve(wb);
+
+                fp -= gb * wb.dot(Mc.head(k2));
+                fpp -= 2.0 * gb * wb.dot(Mp.head(k2)) + gb * gb * wb.dot(Mw.head(k2));
+
+                pk += gb * wb;
+            }
+
+            d(b) = 0.0;
+
+            fpp = std::max(constants::eps_<Float> * fpp0, fpp);
+            dtMin = -fp / fpp;
+            tOld = t(b);
+        }
+
+        dtMin = std::max(dtMin, Float(0.0));
+        tOld += dtMin;
+
+        for(; idx < order.size(); ++idx)
+            xc(order[idx]) = x(order[idx]) + tOld * d(order[idx]);
+
+        for(int i = 0; i < n; ++i)
+            if(t(i) == std::numeric_limits<Float>::infinity())
+                xc(i) = x(i) + tOld * d(i);
+
+        ck += dtMin * pk;
+    }
+
+    /** @brief Minimizes the model over the variables free at @c xc, overwriting it with the truncated minimizer
+     *
+     *  @details With @c Z the free variables, the reduced hessian is @f$\theta I - W_Z M W_Z^\intercal@f$, whose inverse
+     * 			 is @f$\frac{1}{\theta} I + \frac{1}{\theta^2} W_Z (I - \frac{1}{\theta} M W_Z^\intercal W_Z)^{-1} M W_Z^\intercal@f$.
+    */
+    template <class V>
+    void subspaceMinimization (const V& x, const V& gx, const V& l, const V& u, Float theta, V& xc)
+    {
+        int n = x.size(), k2 = 2 * history.size;
+
+        free.clear();
+
+        for(int i = 0; i < n; ++i)
+            if(xc(i) > l(i) && xc(i) < u(i))
+                free.push_back(i);
+
+        int nf = free.size();
+
+        if(!nf)
+            return;
+
+        auto rf = r.head(nf);
+        auto du = d.head(nf);
+
+        if(k2)
+            Mc.head(k2) = lu.solve(c.head(k2));
+
+        for(int a = 0; a < nf; ++a)
+        {
+            int i = free[a];
+
+            rf(a) = gx(i) + theta * (xc(i) - x(i));
+
+            if(k2)
+            {
+                WZ.row(a).head(k2) = Wb.row(i).head(k2);
+                rf(a) -= Wb.row(i).head(k2).dot(Mc.head(k2));
+            }
+        }
+
+        du = -rf / theta;
+
+        if(k2)
+        {
+            auto W = WZ.topLeftCorner(nf, k2);
+            auto vk = v.head(k2);
+
+            vk.noalias() = W.transpose() * rf;
+            vk = lu.solve(vk);
+
+            auto Nk = N.topLeftCorner(k2, k2);
+
+            Nk.noalias() = W.transpose() * W;
+            Nk = MatX<Float>::Identity(k2, k2) - lu.solve(Nk) / theta;
+
+            luN.compute(Nk);
+
+            vk = luN.solve(vk);
+
+            du.noalias() -= W * vk / (theta * theta);
+        }
+
+        /// Largest step up to 1 keeping the free variables in the box
+        Float alpha = 1.0;
+
+        for(int a = 0; a < nf; ++a)
+        {
+            int i = free[a];
+
+            if(du(a) > 0.0)
+                alpha = std::min(alpha, (u(i) - xc(i)) / du(a));
+
+            else if(du(a) < 0.0)
+                alpha = std::min(alpha, (l(i) - xc(i)) / du(a));
+        }
+
+        for(int a = 0; a < nf; ++a)
+            xc(free[a]) += alpha * du(a);
+    }
+
+
+    MatX<Float> Wb;                     ///< @f$[Y \ \theta S]@f$, in chronological order
+    MatX<Float> WZ;                     ///< Rows of @c Wb of the free variables
+    MatX<Float> K;                      ///< Inverse of the middle matrix @c M
+    Eigen::PartialPivLU<MatX<Float>> lu;
+    MatX<Float> N;                      ///< @f$I - \frac{1}{\theta} M W_Z^\intercal W_Z@f$
+    Eigen::PartialPivLU<MatX<Float>> luN;
+
+    VecX<Float> p, c, v, Mc, Mp, Mw;
+
+    VecX<Float> t;                      ///< Breakpoints
+    VecX<Float> d;
+    VecX<Float> r;
+
+    std::vector<int> order;             ///< Finite breakpoints, in increasing order
+    std::vector<int> free;              ///< Free variables at the Cauchy point
+};
+
+} // namespace impl
+
+
+
+template <class InitialHessian = LBFGS_Scaling<>, class LineSearch = lbfgsb::Backtracking<>,
+          class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<0>,
+          typename Float = types::Float, class History = lbfgs::Compact<Float>>
+struct LBFGSB : public impl::LBFGSB<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian, Float, History>,
+			    public GradientOptimizer<LBFGSB<InitialHessian, LineSearch, Stop, Output, Float, History>>
+{
+    CPPOPT_USING_PARAMS(Impl, impl::LBFGSB<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian, Float, History>);
+    using Impl::Impl;
+
+    LBFGSB (const VecX<Float>& lower, const VecX<Float>& upper)
+    {
+        Impl::lower = lower;
+        Impl::upper = upper;
+    }
+
+    template <class Function, class V>
+    V optimize (Function f, V x)
+    {
+        return Impl::optimize(f, x);
+    }
+};
+
+
+} // namespace nlpp
@@ -0,0 +1,258 @@
+/** @file
+
+    @brief Orthant-Wise Limited-memory Quasi-Newton (Andrew and Gao), for @f$F(x) = f(x) + C \|x\|_1@f$
+
+    @details @c f is smooth and @c C is the weight @c l1 of the regularization. Inside an orthant the @f$\ell_1@f$ term
+             is linear, so L-BFGS is run on the pairs of the smooth gradient, with three changes:
+
+             - The gradient is replaced by the pseudo-gradient of @c F, the minimum norm subgradient.
+             - Direction components whose sign does not agree with the steepest descent direction are set to zero.
+             - Each trial point of the line search is projected on the orthant of the current point, so variables
+               crossing zero stop at zero.
+
+             A variable at zero whose partial derivative is smaller than @c C in absolute value has a null
+             pseudo-gradient, and thus a null direction component, so it stays exactly at zero. The solutions are
+             sparse, and the iterates as well.
+
+             These variables are left out of the direction: with a @c lbfgs::Ring history the two loop recursion runs
+             on the rows of the others only, so the cost of an iteration shrinks with the active set.
+**/
+
+#pragma once
+
+#include "../LBFGS/LBFGS.h"
+
+
+namespace nlpp
+{
+
+namespace owlqn
+{
+
+/** @brief Backtracking on the projected arc @f$x(a) = \pi(x + a p)@f$
+ *
+ *  @details Accepts the first step satisfying @f$F(x(a)) \leq F(x) + c \diamond f(x)^\intercal (x(a) - x)@f$, where
+ * 			 @f$\diamond f@f$ is the pseudo-gradient.
+*/
+template <typename Float = types::Float>
+struct Backtracking
+{
+	Backtracking (Float a0 = 1.0, Float c = 1e-4, Float rho = 0.5, Float aMin = constants::eps_<Float>) :
+				  a0(a0), c(c), rho(rho), aMin(aMin)
+	{
+		assert(c < 1.0 && "c must be smaller than 1.0");
+		assert(rho < 1.0 && "rho must be smaller than 1.0");
+	}
+
+	void initialize () {}
+
+
+	/** @brief Returns the accepted step, writing the point on @c x, the gradient of @c f on @c gx and @c F on @c fx
+	 *
+	 *  @param fx0 The value of @c F (not @c f) at @c x0
+	 *  @param pg The pseudo-gradient at @c x0
+	*/
+	template <class Function, class V>
+	Float operator () (Function f, Float l1, const V& x0, Float fx0, const V& pg, const V& p, V& x, V& gx, Float& fx)
+	{
+		Float a = a0;
+
+		while(true)
+		{
+			project(x0, pg, p, a, x);
+
+			fx = f(x, gx) + l1 * x.template lpNorm<1>();
+
+			if(fx <= fx0 + c * pg.dot(x - x0) || a < aMin)
+				return a;
+
+			a = rho * a;
+		}
+	}
+
+	/// Zero the components of @f$x_0 + a p@f$ leaving the orthant of @c x0 (or of @c -pg, where @c x0 is zero)
+	template <class V>
+	static void project (const V& x0, const V& pg, const V& p, Float a, V& x)
+	{
+		auto orthant = (x0.array() != 0.0).select(x0.array(), -pg.array());
+
+		x.array() = ((x0 + a * p).array() * orthant > 0.0).select((x0 + a * p).array(), Float(0.0));
+	}
+
+
+	Float a0;		///< Initial step
+
+	Float c;		///< Factor of the sufficient decrease condition
+
+	Float rho;		///< Factor to reduce @c a
+
+	Float aMin;		///< Smallest step acceptable
+};
+
+} // namespace owlqn
+
+
+namespace impl
+{
+
+namespace params
+{
+
+template <class Params_, typename Float = types::Float>
+struct OWLQN : public Params_
+{
+	CPPOPT_USING_PARAMS(Params, Params_);
+	using Params::Params;
+
+
+	Float l1 = 1.0;		///< Weight of the @f$\ell_1@f$ regularization
+};
+
+} // namespace params
+
+
+/** @brief OWL-QN
+ *
+ *  @tparam Float Scalar of @c l1 and of the variables
+*/
+template <class Params_, class InitialHessian = LBFGS_Scaling<>, typename Float = types::Float, class History = lbfgs::Ring<Float>>
+struct OWLQN : public LBFGS<params::OWLQN<Params_, Float>, InitialHessian, History>
+{
+    CPPOPT_USING_PARAMS_LBFGS(Params, LBFGS<params::OWLQN<Params_, Float>, InitialHessian, History>);
+    using Params::Params;
+    using Params::l1;
+    using Params::initHessian;
+    using Params::updateHessian;
+
+
+	template <class Function, class V>
+	V optimize (Function f, V x0)
+	{
+        static_assert(std::is_same<impl::Scalar<V>, Float>::value, "The variables must have the scalar of l1");
+
+        V x(x0.rows(), x0.cols()), p(x0.rows(), x0.cols());
+        V gx(x0.rows(), x0.cols()), gx0(x0.rows(), x0.cols());
+        V pg(x0.rows(), x0.cols()), pg0(x0.rows(), x0.cols());
+        Float fx0, fx;
+
+        fx0 = f(x0, gx0) + l1 * x0.template lpNorm<1>();
+
+        pseudoGradient(x0, gx0, l1, pg0);
+
+        history.init(x0.size(), m);
+
+        initHessian(pg0, Precedence<0>{});
+
+        std::vector<int> active;
+
+        for(int iter = 0; iter < stop.maxIterations(); ++iter)
+        {
+            auto H = initialHessian(f, x0);
+
+            direction(x0, pg0, H, p, active, Precedence<0>{});
+
+            p = (p.array() * pg0.array() < 0.0).select(p, 0.0);
+
+            /// The curvature pairs can still give an ascent direction after the sign constraint
+            if(p.dot(pg0) >= 0.0)
+                p = -pg0;
+
+            lineSearch(f, l1, x0, fx0, pg0, p, x, gx, fx);
+
+            pseudoGradient(x, gx, l1, pg);
+
+            if(stop(*this, x, fx, pg))
+                return x;
+
+            /// The pairs come from the smooth part only
+            if((x - x0).dot(gx - gx0) > constants::eps_<Float> * (gx - gx0).squaredNorm())
+            {
+                history.update(x - x0, gx - gx0);
+
+                updateHessian(x - x0, gx - gx0, Precedence<0>{});
+            }
+
+            x0.swap(x);
+            gx0.swap(gx);
+            pg0.swap(pg);
+            fx0 = fx;
+
+            output(*this, x0, fx0, pg0);
+        }
+
+        return x0;
+	}
+
+
+    /// Two loop recursion on the variables that are not fixed at zero (nonzero or with a nonzero pseudo-gradient)
+    template <class V, class H, class Hist = History>
+    auto direction (const V& x, const V& pg, const H& h, V& p, std::vector<int>& active, Precedence<0>)
+        -> decltype(std::declval<Hist&>().direction(pg, h, p, active), void())
+    {
+        active.clear();
+
+        for(int i = 0; i < x.size(); ++i)
+            if(x(i) != 0.0 || pg(i) != 0.0)
+                active.push_back(i);
+
+        if(active.size() == std::size_t(x.size()))
+            history.direction(pg, h, p);
+
+        else
+            history.direction(pg, h, p, active);
+    }
+
+    /// Other histories take the full recursion
+    template <class V, class H>
+    void direction (const V&, const V& pg, const H& h, V& p, std::vector<int>&, Precedence<1>)
+    {
+        history.direction(pg, h, p);
+    }
+
+
+    /// Minimum norm subgradient of @f$f(x) + C \|x\|_1@f$, given the gradient @c gx of @c f
+    template <class V>
+    static void pseudoGradient (const V& x, const V& gx, Float l1, V& pg)
+    {
+        for(int i = 0; i < x.size(); ++i)
+        {
+            if(x(i) > 0.0)
+                pg(i) = gx(i) + l1;
+
+            else if(x(i) < 0.0)
+                pg(i) = gx(i) - l1;
+
+            else if(gx(i) + l1 < 0.0)
+                pg(i) = gx(i) + l1;
+
+            else if(gx(i) - l1 > 0.0)
+                pg(i) = gx(i) - l1;
+
+            else
+                pg(i) = 0.0;
+        }
+    }
+};
+
+} // namespace impl
+
+
+
+template <class InitialHessian = LBFGS_Scaling<>, class LineSearch = owlqn::Backtracking<>,
+          class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<0>,
+          typename Float = types::Float, class History = lbfgs::Ring<Float>>
+struct OWLQN : public impl::OWLQN<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian, Float, History>,
+			   public GradientOptimizer<OWLQN<InitialHessian, LineSearch, Stop, Output, Float, History>>
+{
+    CPPOPT_USING_PARAMS(Impl, impl::OWLQN<params::LineSearchOptimizer<LineSearch, Stop, Output>, InitialHessian, Float, History>);
+    using Impl::Impl;
+
+    template <class Function, class V>
+    V optimize (Function f, V x)
+    {
+        return Impl::optimize(f, x);
+    }
+};
+
+
+} // namespace nlpp
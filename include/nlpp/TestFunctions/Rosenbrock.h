@@ -6,15 +6,20 @@
 namespace nlpp
 {
 
-struct Rosenbrock
+struct Rosenbrock : public ad::Differentiable
 {
+	/// Generic on the scalar type, so it can also be evaluated with automatic differentiation types
 	template <class Derived>
-	double operator () (const Eigen::MatrixBase<Derived>& x)
+	impl::Scalar<Derived> operator () (const Eigen::MatrixBase<Derived>& x)
 	{
-		double r = 0.0;
+		impl::Scalar<Derived> r = 0.0;
 
         for(int i = 0; i < x.rows() - 1; ++i)
-        	r += 100.0 * std::pow(x(i+1) - std::pow(x(i), 2), 2) + std::pow(x(i) - 1.0, 2);
+        {
+        	impl::Scalar<Derived> a = x(i+1) - x(i) * x(i), b = x(i) - 1.0;
+
+        	r += 100.0 * a * a + b * b;
+        }
 
         return r;
 	}
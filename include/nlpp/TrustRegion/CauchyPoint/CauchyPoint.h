@@ -20,7 +20,7 @@ struct CauchyPoint
 
 		V p = -(delta / gxNorm) * gx;
 
-		Float quad = gx.transpose() * hx * gx;
+		Float quad = gx.dot(hx * gx);
 
 		if(quad > constants::eps_<Float>)
 			p = std::min(1.0, std::pow(gxNorm, 3) / (delta * quad)) * p;
@@ -2,6 +2,8 @@
 
 #include "../TrustRegion.h"
 
+#include "../../Newton/Factorizations.h"
+
 
 namespace nlpp
 {
@@ -9,17 +11,29 @@ namespace nlpp
 namespace impl
 {
 
+/// @c M is the type of the hessian, dense or sparse. For a sparse one, the symbolic factorization is done only once
+template <class M = Mat>
 struct DogLeg
 {
-	template <class Function, class Hessian, class V, class M, typename Float>
+	template <class Function, class Hessian, class V, typename Float>
 	auto operator() (Function function, Hessian hessia, const V& x, const V& gx, const M& hx, Float delta)
 	{
-		V pb = -hx.ldlt().solve(gx);
+		solver.compute(hx);
+
+		V pb = -solver.solve(gx);
 
 		if(pb.norm() <= delta)
 			return std::tuple_cat(std::make_tuple(pb), function(x + pb));
 
-		V pu = -(gx.dot(gx) / (gx.transpose() * hx * gx)) * gx;
+		V pu = -(gx.dot(gx) / gx.dot(hx * gx)) * gx;
+
+		/// The first leg already leaves the region, so the second one never crosses its border
+		if(pu.norm() >= delta)
+		{
+			pu *= delta / pu.norm();
+
+			return std::tuple_cat(std::make_tuple(pu), function(x + pu));
+		}
 		V diff = (pb - pu);
 
 		Float a = diff.squaredNorm();
@@ -41,12 +55,19 @@ struct DogLeg
 		
 		return std::tuple_cat(std::make_tuple(du), uEval);
 	}
+
+
+	SymmetricSolver<M> solver;
 };
 
 } // namespace impl
 
 template <class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<>, typename Float = types::Float>
-using DogLeg = TrustRegion<impl::DogLeg, Stop, Output, Float>;
+using DogLeg = TrustRegion<impl::DogLeg<>, Stop, Output, Float>;
+
+/// Dog leg with a sparse hessian, given by the user or by ::nlpp::fd::sparseHessian
+template <class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<>, typename Float = types::Float>
+using SparseDogLeg = TrustRegion<impl::DogLeg<Eigen::SparseMatrix<Float>>, Stop, Output, Float>;
 
 
 namespace poly
@@ -57,10 +78,10 @@ namespace impl
 
 template <class V = ::nlpp::Vec, class M = ::nlpp::Mat>
 struct DogLeg : public LocalMinimizerBase<V, M>,
-				public ::nlpp::impl::DogLeg
+				public ::nlpp::impl::DogLeg<M>
 {
 	using Interface = LocalMinimizerBase<V, M>;
-	using Impl = ::nlpp::impl::DogLeg;
+	using Impl = ::nlpp::impl::DogLeg<M>;
 	using Float = ::nlpp::impl::Scalar<V>;
 
 	virtual std::tuple<V, Float, V> operator () (::nlpp::wrap::poly::FunctionGradient<V> function, ::nlpp::wrap::poly::Hessian<V, M> hessian,
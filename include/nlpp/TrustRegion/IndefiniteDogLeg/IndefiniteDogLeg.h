@@ -147,7 +147,7 @@ struct IndefiniteDogLeg
 		if(best.norm() == 0.0)
 		{
 			if(hx.llt().info() == Eigen::Success)
-				return DogLeg{}(function, hessian, x, gx, hx, delta);
+				return DogLeg<M>{}(function, hessian, x, gx, hx, delta);
 			
 			return CauchyPoint{}(function, hessian, x, gx, hx, delta);
 		}
@@ -0,0 +1,138 @@
+/** @file
+ *  @brief Steihaug-Toint truncated CG, the trust region local minimizer for large problems
+ *
+ *  @details Linear CG on the quadratic model, starting from zero (algorithm 7.2 of NOCEDAL). It stops at the border
+ * 			 of the region when an iterate leaves it or a direction of nonpositive curvature is found, or when the
+ * 			 residual is below @f$\min(\eta, \sqrt{\|g\|}) \|g\|@f$. Only products with the hessian are needed, so the
+ * 			 trust region is run with a wrap::hessianOperator, and the hessian is never formed if the functor given
+ * 			 has a product interface. The poly variant is the exception, as its interface takes a dense hessian.
+*/
+
+#pragma once
+
+#include "../TrustRegion.h"
+
+
+namespace nlpp
+{
+
+namespace impl
+{
+
+template <typename Float = types::Float>
+struct Steihaug
+{
+	static constexpr bool matrixFree = true;
+
+
+	Steihaug (Float eta = 0.5, int maxIterations = 0) : eta(eta), maxIterations(maxIterations) {}
+
+
+	template <class Function, class Hessian, class V, class M>
+	auto operator() (Function function, Hessian, const V& x, const V& gx, const M& hx, Float delta)
+	{
+		V p = V::Zero(gx.rows(), gx.cols()), r = gx, d = -gx, hd;
+
+		Float rr = r.squaredNorm(), tol = std::pow(std::min(eta, std::pow(rr, 0.25)), 2) * rr;
+
+		int maxIter = maxIterations > 0 ? maxIterations : gx.size();
+
+		for(int iter = 0; iter < maxIter && rr > tol; ++iter)
+		{
+			hd = hx * d;
+
+			Float dhd = d.dot(hd);
+
+			/// The model decreases along d without bound, so follow it until the border
+			if(!(dhd > 0.0))
+			{
+				p += border(p, d, delta) * d;
+				break;
+			}
+
+			Float a = rr / dhd;
+
+			if((p + a * d).norm() >= delta)
+			{
+				p += border(p, d, delta) * d;
+				break;
+			}
+
+			p.noalias() += a * d;
+			r.noalias() += a * hd;
+
+			Float rrNew = r.squaredNorm();
+
+			d = (rrNew / rr) * d - r;
+			rr = rrNew;
+		}
+
+		return std::tuple_cat(std::make_tuple(p), function(x + p));
+	}
+
+	/// The positive @c t where @f$\|p + t d\| = \Delta@f$, given @f$\|p\| < \Delta@f$
+	template <class V>
+	static Float border (const V& p, const V& d, Float delta)
+	{
+		Float dd = d.squaredNorm(), pd = p.dot(d), pp = p.squaredNorm();
+
+		return (-pd + std::sqrt(pd * pd + dd * (delta * delta - pp))) / dd;
+	}
+
+
+	Float eta;				///< Upper bound of the relative residual
+	int maxIterations;		///< Maximum number of CG iterations. If 0, the dimension is used
+};
+
+} // namespace impl
+
+template <class Stop = stop::GradientOptimizer<>, class Output = out::GradientOptimizer<>, typename Float = types::Float>
+using Steihaug = TrustRegion<impl::Steihaug<Float>, Stop, Output, Float>;
+
+
+namespace poly
+{
+
+namespace impl
+{
+
+/** @brief Steihaug behind the local minimizer interface
+ *
+ *  @details The interface passes the hessian as a @c M, so poly::TrustRegion evaluates it at every accepted point and
+ * 			 this variant is not matrix free. Use nlpp::Steihaug to work with hessian vector products only.
+*/
+template <class V = ::nlpp::Vec, class M = ::nlpp::Mat>
+struct Steihaug : public LocalMinimizerBase<V, M>,
+				  public ::nlpp::impl::Steihaug<::nlpp::impl::Scalar<V>>
+{
+	using Interface = LocalMinimizerBase<V, M>;
+	using Impl = ::nlpp::impl::Steihaug<::nlpp::impl::Scalar<V>>;
+	using Float = ::nlpp::impl::Scalar<V>;
+
+	virtual std::tuple<V, Float, V> operator () (::nlpp::wrap::poly::FunctionGradient<V> function, ::nlpp::wrap::poly::Hessian<V, M> hessian,
+												 const V& x, const V& gx, const M& hx, Float delta)
+	{
+		return Impl::operator()(function, hessian, x, gx, hx, delta);
+	}
+
+	virtual Steihaug* clone_impl () const { return new Steihaug(*this); }
+};
+
+} // namespace impl
+
+
+template <class V = ::nlpp::Vec, class M = ::nlpp::Mat>
+struct Steihaug : public TrustRegion<V, M>
+{
+	using Base = TrustRegion<V, M>;
+
+	template <typename... Args>
+	Steihaug (Args&&... args) : Base(std::forward<Args>(args)...)
+	{
+		Base::localOptimizer = std::make_unique<impl::Steihaug<V, M>>();
+	}
+};
+
+} // namespace poly
+
+} // namespace nlpp
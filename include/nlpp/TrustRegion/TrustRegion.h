@@ -67,7 +67,8 @@ struct TrustRegion : public ::nlpp::params::TrustRegion<LocalOptimizer, Params_,
 
         std::tie(fx, gx) = function(x);
 
-		Mat hx = hessian(x);
+		/// Dense or sparse, as given by the hessian functor, or only an operator if the local minimizer is matrix free
+		auto hx = hessianModel(hessian, x, gx, Precedence<0>{});
 
 
 		for(int iter = 0; iter < stop.maxIterations(); ++iter)
@@ -78,7 +79,7 @@ struct TrustRegion : public ::nlpp::params::TrustRegion<LocalOptimizer, Params_,
 
 			Float aRed = (fx - fxp);	/// Actual reduction 
 
-			Float pRed = -(gx.dot(p) + 0.5 * p.transpose() * hx * p);	/// Predicted reduction
+			Float pRed = -(gx.dot(p) + 0.5 * p.dot(hx * p));	/// Predicted reduction
 
 			/** Ratio between actual and predicted reduction. 'pRed' SHOULD always be positive, but I am also 
 			 *  handling the case where the trust region direction fails miserably and returns a worst solution.
@@ -93,14 +94,14 @@ struct TrustRegion : public ::nlpp::params::TrustRegion<LocalOptimizer, Params_,
 			{
 				handy::print("FAIL HARD");
 				handy::print("\n\n\n", fx, "     ", fxp, "          ", gx.transpose(), "          ", p.transpose(), "\n\n");
-				std::cout << hx << "\n\n";
                 exit(0);
 			}
 
 
 
-			/// If this is the maximum allowed value for delta and we had this small improvement, theres nothing else to do
-			if(aRed < constants::eps_<Float> && delta == maxDelta)
+			/// If this is the maximum allowed value for delta and we had this small improvement, theres nothing else to do.
+			/// A step increasing the function is not an improvement, it only shrinks the region
+			if(std::abs(aRed) < constants::eps_<Float> && delta == maxDelta)
 				return x;
 
 			/// If rho is smaller than this threshold, reduce the trust region size
@@ -128,12 +129,45 @@ struct TrustRegion : public ::nlpp::params::TrustRegion<LocalOptimizer, Params_,
 			if(rho > eta)
 			{
                 std::tie(x, fx, gx) = std::tie(x + p, fxp, gxp);
-				hx = hessian(x);
+				update(hx, hessian, x);
 			}
 		}
 
 		return x;
 	}
+
+
+	/** @name
+	 *  @brief The hessian given to the local minimizer
+	 *
+	 *  @details A local minimizer needing only hessian vector products declares a static @c matrixFree member set to
+	 * 			 true. It is then given a wrap::hessianOperator, which follows the updates of @c x without evaluating
+	 * 			 the hessian.
+	*/
+	//@{
+	template <class Hessian, class V, class LO = LocalOptimizer, std::enable_if_t<LO::matrixFree, int> = 0>
+	static auto hessianModel (Hessian& hessian, const V& x, const V& gx, Precedence<0>)
+	{
+		return ::nlpp::wrap::hessianOperator(hessian, x, gx);
+	}
+
+	template <class Hessian, class V>
+	static auto hessianModel (Hessian& hessian, const V& x, const V&, Precedence<1>)
+	{
+		return impl::Plain<decltype(hessian(x))>(hessian(x));
+	}
+
+	template <class M, class Hessian, class V>
+	static void update (M& hx, Hessian& hessian, const V& x)
+	{
+		hx = hessian(x);
+	}
+
+	template <class H, class W, class Hessian, class V>
+	static void update (::nlpp::wrap::HessianProduct<H, W>&, Hessian&, const V&)
+	{
+	}
+	//@}
 };
 
 } // namespace impl
@@ -155,8 +189,22 @@ struct TrustRegion : public impl::TrustRegion<LocalMinimizer, params::Optimizer<
 	template <class Function, class V>
 	V optimize (Function f, V x)
 	{
-		return optimize(f, ::nlpp::fd::hessian(f), x);
-	}	
+		return optimize(f, defaultHessian(f, impl::Precedence<0>{}), x);
+	}
+
+
+	/// A matrix free local minimizer takes its products from differences of the gradient, even a finite difference one
+	template <class Function, class LM = LocalMinimizer, std::enable_if_t<LM::matrixFree, int> = 0>
+	static auto defaultHessian (const Function& f, impl::Precedence<0>)
+	{
+		return ::nlpp::fd::gradientHessian(f);
+	}
+
+	template <class Function>
+	static auto defaultHessian (const Function& f, impl::Precedence<1>)
+	{
+		return ::nlpp::fd::hessian(f);
+	}
 };
 
 
@@ -164,7 +212,7 @@ namespace poly
 {
 
 template <class V = ::nlpp::Vec, class M = ::nlpp::Mat>
-struct LocalMinimizerBase : public ::nlpp::poly::CloneBase<LocalMinimizerBase<V>>
+struct LocalMinimizerBase : public ::nlpp::poly::CloneBase<LocalMinimizerBase<V, M>>
 {
 	using Float = ::nlpp::impl::Scalar<V>;
 
@@ -175,11 +223,12 @@ struct LocalMinimizerBase : public ::nlpp::poly::CloneBase<LocalMinimizerBase<V>
 
 
 template <class V = ::nlpp::Vec, class M = ::nlpp::Mat>
-struct LocalMinimizer_ : public ::nlpp::poly::PolyClass<LocalMinimizer_<V, M>>
+struct LocalMinimizer_ : public ::nlpp::poly::PolyClass<LocalMinimizerBase<V, M>>
 {
-    NLPP_USING_POLY_CLASS(LocalMinimizer_, Base, ::nlpp::poly::PolyClass<LocalMinimizer_<V, M>>);
+    NLPP_USING_POLY_CLASS(LocalMinimizer_, Base, ::nlpp::poly::PolyClass<LocalMinimizerBase<V, M>>);
 
-    // LocalMinimizer_ () : Base(std::make_unique<CauchyPoint<>>()) {}
+    /// Set by each poly trust region
+    LocalMinimizer_ () : Base(nullptr) {}
 
     using Float = ::nlpp::impl::Scalar<V>;
 
@@ -0,0 +1,147 @@
+#include "gtest/gtest.h"
+
+#include "Helpers/Wrappers.h"
+
+#include "TestFunctions/Rosenbrock.h"
+
+
+namespace
+{
+
+struct AutoDiffTest : public ::testing::Test
+{
+    virtual ~AutoDiffTest () {}
+
+    /// Exact Rosenbrock gradient
+    static nlpp::Vec rosenbrockGradient (const nlpp::Vec& x)
+    {
+        nlpp::Vec g = nlpp::Vec::Zero(x.size());
+
+        for(int i = 0; i < x.size() - 1; ++i)
+        {
+            g(i) += -400.0 * x(i) * (x(i+1) - x(i) * x(i)) + 2.0 * (x(i) - 1.0);
+            g(i+1) += 200.0 * (x(i+1) - x(i) * x(i));
+        }
+
+        return g;
+    }
+};
+
+
+TEST_F(AutoDiffTest, GradientTest)
+{
+    SCOPED_TRACE("Forward AD Gradient Test");
+
+    handy::RandDouble rng; for(int numVariables : {1, 7, 8, 9, 50})
+    {
+        nlpp::Vec x(numVariables), d(numVariables);
+
+        std::for_each(x.data(), x.data() + x.size(), [&rng](auto& xi) { xi = rng(-10.0, 10.0); });
+        std::for_each(d.data(), d.data() + d.size(), [&rng](auto& di) { di = rng(-1.0, 1.0); });
+
+        SCOPED_TRACE((std::string("X: ") + nlpp::impl::toString(x)).c_str());
+
+        auto grad = nlpp::ad::gradient(nlpp::Rosenbrock{});
+
+        nlpp::Vec g;
+        double fx = grad.functionGradient(x, g);
+        nlpp::Vec gx = rosenbrockGradient(x);
+
+        EXPECT_DOUBLE_EQ(fx, nlpp::Rosenbrock{}(x));
+        EXPECT_LE((g - gx).norm(), 1e-12 * gx.norm());
+        EXPECT_NEAR(grad.directional(x, d), gx.dot(d), 1e-12 * gx.norm() * d.norm());
+    }
+}
+
+
+TEST_F(AutoDiffTest, ReverseGradientTest)
+{
+    SCOPED_TRACE("Reverse AD Gradient Test");
+
+    auto fg = nlpp::wrap::functionGradient(nlpp::Rosenbrock{}, nlpp::ad::reverse(nlpp::Rosenbrock{}));
+
+    handy::RandDouble rng; for(int numVariables : {1, 2, 50, 1000})
+    {
+        nlpp::Vec x(numVariables), g;
+
+        std::for_each(x.data(), x.data() + x.size(), [&rng](auto& xi) { xi = rng(-10.0, 10.0); });
+
+        SCOPED_TRACE((std::string("N: ") + std::to_string(numVariables)).c_str());
+
+        double fx = fg(x, g);
+        nlpp::Vec gx = rosenbrockGradient(x);
+
+        EXPECT_DOUBLE_EQ(fx, nlpp::Rosenbrock{}(x));
+        EXPECT_LE((g - gx).norm(), 1e-12 * gx.norm());
+
+        /// The tape is reset, not freed, so a second call records exactly the same operations in the same storage
+        auto capacity = fg.tape.nodes.capacity();
+        auto size = fg.tape.nodes.size();
+
+        fg(x, g);
+
+        EXPECT_EQ(fg.tape.nodes.capacity(), capacity);
+        EXPECT_EQ(fg.tape.nodes.size(), size);
+        EXPECT_EQ(nlpp::ad::Tape<double>::active(), nullptr);
+    }
+}
+
+
+TEST_F(AutoDiffTest, WrapperSelectionTest)
+{
+    SCOPED_TRACE("Forward AD Wrapper Selection Test");
+
+    auto plain = [](const nlpp::Vec& x){ return x.squaredNorm(); };
+
+    static_assert(std::is_same<nlpp::wrap::FunctionGradient<nlpp::Rosenbrock>,
+                  nlpp::wrap::impl::FunctionGradient<nlpp::Rosenbrock, nlpp::ad::Gradient<nlpp::Rosenbrock>>>::value,
+                  "Generic functors must use automatic differentiation");
+
+    static_assert(std::is_same<nlpp::wrap::FunctionGradient<decltype(plain)>,
+                  nlpp::wrap::impl::FunctionGradient<decltype(plain), nlpp::fd::Gradient<decltype(plain)>>>::value,
+                  "Functors taking only nlpp::Vec must use finite differences");
+
+    nlpp::Vec x = nlpp::Vec::Constant(20, -1.5);
+
+    auto fg = nlpp::wrap::functionGradient(nlpp::Rosenbrock{});
+
+    auto [fx, gx] = fg(x);
+
+    EXPECT_DOUBLE_EQ(fx, nlpp::Rosenbrock{}(x));
+    EXPECT_LE((gx - rosenbrockGradient(x)).norm(), 1e-12 * gx.norm());
+}
+
+
+/// Generic, but calling qualified std functions, which have no overloads for duals
+struct StdFunction
+{
+    template <class Derived>
+    nlpp::impl::Scalar<Derived> operator () (const Eigen::MatrixBase<Derived>& x)
+    {
+        return std::pow(x(0), 3) + std::sin(x(1));
+    }
+};
+
+TEST_F(AutoDiffTest, UntaggedWrapperSelectionTest)
+{
+    SCOPED_TRACE("Untagged Generic Functor Wrapper Selection Test");
+
+    auto deduced = [](const auto& x){ return std::pow(x(0), 3) + std::sin(x(1)); };
+
+    static_assert(std::is_same<nlpp::wrap::FunctionGradient<StdFunction>,
+                  nlpp::wrap::impl::FunctionGradient<StdFunction, nlpp::fd::Gradient<StdFunction>>>::value,
+                  "Generic functors without the ad::Differentiable tag must use finite differences");
+
+    static_assert(std::is_same<nlpp::wrap::FunctionGradient<decltype(deduced)>,
+                  nlpp::wrap::impl::FunctionGradient<decltype(deduced), nlpp::fd::Gradient<decltype(deduced)>>>::value,
+                  "Generic functors without the ad::Differentiable tag must use finite differences");
+
+    nlpp::Vec x(2), g(2);
+    x << 0.5, 1.5;
+    g << 3 * x(0) * x(0), std::cos(x(1));
+
+    EXPECT_LE((nlpp::wrap::functionGradient(StdFunction{}).gradient(x) - g).norm(), 1e-6);
+    EXPECT_LE((nlpp::wrap::functionGradient(deduced).gradient(x) - g).norm(), 1e-6);
+}
+
+} // namespace
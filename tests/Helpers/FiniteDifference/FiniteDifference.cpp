@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 
 #include "Helpers/FiniteDifference.h"
+#include "Helpers/SparseFiniteDifference.h"
+#include "TestFunctions/Rosenbrock.h"
 
 
 namespace
@@ -97,6 +99,212 @@ TEST_F(FiniteDifferenceTest, GradientTest)
 }
 
 
+TEST_F(FiniteDifferenceTest, ParallelGradientTest)
+{
+    SCOPED_TRACE("Parallel Finite Gradient Test");
+
+    /// Each worker must get its own copy of this functor, so the counter is never shared between threads
+    struct Counted
+    {
+        double operator () (const nlpp::Vec& x)
+        {
+            calls++;
+
+            return x.squaredNorm() + x.array().sin().sum();
+        }
+
+        int calls = 0;
+    };
+
+    handy::RandDouble rng; nlpp::Vec x(50); for(int i = 0; i < 10; ++i)
+    {
+        std::for_each(x.data(), x.data() + x.size(), [&rng](auto& xi) { xi = rng(-10.0, 10.0); });
+
+        SCOPED_TRACE((std::string("X: ") + nlpp::impl::toString(x)).c_str());
+
+        auto seqG = nlpp::fd::gradient<Counted, nlpp::fd::Central>(Counted{});
+        auto parG = nlpp::fd::gradient<Counted, nlpp::fd::Central>(Counted{}, nlpp::fd::Parallel(4));
+
+        testGradient(parG, seqG, x, 1e-20);
+
+        EXPECT_EQ(parG.f.calls, 0);
+    }
+}
+
+
+TEST_F(FiniteDifferenceTest, BatchGradientTest)
+{
+    SCOPED_TRACE("Batch Finite Gradient Test");
+
+    /// Only has the batch interface, evaluating every column of X at once
+    struct Batch
+    {
+        nlpp::Vec operator () (const nlpp::Mat& X)
+        {
+            calls++;
+
+            return X.colwise().squaredNorm().transpose() + X.array().sin().colwise().sum().matrix().transpose();
+        }
+
+        int calls = 0;
+    };
+
+    auto func = [](const nlpp::Vec& x){ return x.squaredNorm() + x.array().sin().sum(); };
+
+    handy::RandDouble rng; nlpp::Vec x(50); for(int i = 0; i < 10; ++i)
+    {
+        std::for_each(x.data(), x.data() + x.size(), [&rng](auto& xi) { xi = rng(-10.0, 10.0); });
+
+        SCOPED_TRACE((std::string("X: ") + nlpp::impl::toString(x)).c_str());
+
+        auto batchG = nlpp::fd::gradient<Batch, nlpp::fd::Forward>(Batch{}, nlpp::fd::AutoStep{}, nlpp::fd::Sequential(16));
+
+        testGradient(batchG, nlpp::fd::gradient(func), x, 1e-20);
+
+        /// One call for f(x) plus ceil(50 / 16) blocks
+        batchG(x);
+
+        EXPECT_EQ(batchG.f.calls, 5);
+    }
+}
+
+
+/// Generic on the scalar type, so it can be evaluated with complex vectors
+struct GenericFunction
+{
+    template <class Derived>
+    nlpp::impl::Scalar<Derived> operator () (const Eigen::MatrixBase<Derived>& x)
+    {
+        return (x.array() * x.array().sin()).sum() + x.array().exp().sum();
+    }
+};
+
+/// Counts its calls, real or complex
+struct CountedFunction
+{
+    template <class Derived>
+    nlpp::impl::Scalar<Derived> operator () (const Eigen::MatrixBase<Derived>& x)
+    {
+        ++*calls;
+
+        return GenericFunction{}(x);
+    }
+
+    int* calls;
+};
+
+TEST_F(FiniteDifferenceTest, ComplexStepGradientTest)
+{
+    SCOPED_TRACE("Complex Step Gradient Test");
+
+    handy::RandDouble rng; nlpp::Vec x(20); for(int i = 0; i < 10; ++i)
+    {
+        std::for_each(x.data(), x.data() + x.size(), [&rng](auto& xi) { xi = rng(-5.0, 5.0); });
+
+        SCOPED_TRACE((std::string("X: ") + nlpp::impl::toString(x)).c_str());
+
+        nlpp::Vec gx = x.array().sin() + x.array() * x.array().cos() + x.array().exp();
+
+        auto finG = nlpp::fd::gradient<GenericFunction, nlpp::fd::ComplexStep>(GenericFunction{});
+
+        testGradient(finG, [&](const nlpp::Vec&){ return gx; }, x, 1e-24 * gx.squaredNorm());
+    }
+
+    /// A single complex call per coordinate, without the real f(x)
+    int calls = 0;
+
+    auto countedG = nlpp::fd::gradient<CountedFunction, nlpp::fd::ComplexStep>(CountedFunction{&calls});
+
+    nlpp::Vec y = nlpp::Vec::Constant(5, 0.5), gy(5);
+
+    countedG(y);
+    EXPECT_EQ(calls, 5);
+
+    countedG(y, gy);
+    EXPECT_EQ(calls, 10);
+}
+
+
+/// The Rosenbrock hessian is tridiagonal
+nlpp::Mat rosenbrockHessian (const nlpp::Vec& x)
+{
+    nlpp::Mat h = nlpp::Mat::Zero(x.size(), x.size());
+
+    for(int i = 0; i < x.size() - 1; ++i)
+    {
+        h(i, i) += 1200 * x(i) * x(i) - 400 * x(i+1) + 2;
+        h(i+1, i+1) += 200;
+        h(i, i+1) = h(i+1, i) = -400 * x(i);
+    }
+
+    return h;
+}
+
+TEST_F(FiniteDifferenceTest, SparseHessianTest)
+{
+    SCOPED_TRACE("Sparse Finite Hessian Test");
+
+    /// Away from zero, so no off diagonal entry -400 x(i) vanishes by chance when detecting the pattern
+    handy::RandDouble rng; nlpp::Vec x(50); for(int i = 0; i < 10; ++i)
+    {
+        std::for_each(x.data(), x.data() + x.size(), [&rng](auto& xi) { xi = rng(0.5, 2.0); });
+
+        SCOPED_TRACE((std::string("X: ") + nlpp::impl::toString(x)).c_str());
+
+        auto pattern = nlpp::fd::hessianPattern(nlpp::Rosenbrock{}, x);
+
+        EXPECT_EQ(pattern.nonZeros(), 3 * x.size() - 2);
+
+        nlpp::Mat exact = rosenbrockHessian(x);
+
+        auto funcH = nlpp::fd::sparseHessian(nlpp::Rosenbrock{}, pattern);
+        auto gradH = nlpp::fd::sparseGradientHessian(nlpp::ad::reverse(nlpp::Rosenbrock{}), pattern);
+
+        EXPECT_LT((nlpp::Mat(funcH(x)) - exact).norm(), 1e-3 * exact.norm());
+        EXPECT_LT((nlpp::Mat(gradH(x)) - exact).norm(), 1e-6 * exact.norm());
+
+        /// Independent of the dimension: 3 gradient calls for a tridiagonal matrix
+        EXPECT_LE(gradH.numColors, 3);
+
+        /// Two neighbours with the same color cannot be told apart, so the CPR coloring must be used instead
+        std::vector<int> bad(x.size(), 0);
+        bad[0] = 1;
+
+        EXPECT_FALSE(gradH.color(bad, true));
+        EXPECT_TRUE(gradH.color(nlpp::fd::cprColoring(pattern), false));
+        EXPECT_LT((nlpp::Mat(gradH(x)) - exact).norm(), 1e-6 * exact.norm());
+    }
+}
+
+
+TEST_F(FiniteDifferenceTest, GradientHessianTest)
+{
+    SCOPED_TRACE("Gradient Difference Hessian Test");
+
+    /// Wrappers with an exact gradient difference it, instead of using only function values
+    auto fg = nlpp::wrap::functionGradient(nlpp::Rosenbrock{}, nlpp::ad::reverse(nlpp::Rosenbrock{}));
+
+    static_assert(std::is_same<decltype(nlpp::fd::hessian(fg)), nlpp::fd::GradientHessian<decltype(fg)>>::value, "");
+    static_assert(std::is_same<decltype(nlpp::fd::hessian(nlpp::Rosenbrock{})), nlpp::fd::Hessian<nlpp::Rosenbrock>>::value, "");
+
+    handy::RandDouble rng; nlpp::Vec x(30); for(int i = 0; i < 10; ++i)
+    {
+        std::for_each(x.data(), x.data() + x.size(), [&rng](auto& xi) { xi = rng(-2.0, 2.0); });
+
+        SCOPED_TRACE((std::string("X: ") + nlpp::impl::toString(x)).c_str());
+
+        nlpp::Mat exact = rosenbrockHessian(x);
+
+        nlpp::Mat seqH = nlpp::fd::hessian(fg)(x);
+        nlpp::Mat parH = nlpp::fd::gradientHessian(fg, nlpp::fd::Parallel(4))(x);
+
+        EXPECT_LT((seqH - exact).norm(), 1e-6 * exact.norm());
+        EXPECT_EQ((seqH - seqH.transpose()).norm(), 0.0);
+        EXPECT_EQ((parH - seqH).norm(), 0.0);
+    }
+}
+
+
 // TEST_F(FiniteDifferenceTest, HessianTest)
 // {
 //     SCOPED_TRACE("Finite Hessian Test\n");
@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+
+#include "Helpers/Wrappers.h"
+#include "Helpers/AutoDiff.h"
+#include "LineSearch/StrongWolfe/StrongWolfe.h"
+#include "QuasiNewton/BFGS/BFGS.h"
+
+#include "TestFunctions/Rosenbrock.h"
+
+
+namespace
+{
+
+struct WrappersTest : public ::testing::Test
+{
+    virtual ~WrappersTest () {}
+};
+
+
+TEST_F(WrappersTest, CacheTest)
+{
+    SCOPED_TRACE("Cache Test");
+
+    /// Counts the calls of all of its copies
+    struct Counted
+    {
+        double operator () (const ::nlpp::Vec& x)
+        {
+            ++*calls;
+
+            return func(x);
+        }
+
+        std::shared_ptr<int> calls = std::make_shared<int>(0);
+        ::nlpp::Rosenbrock func;
+    };
+
+    for(int numVariables = 10; numVariables <= 50; numVariables += 20)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        ::nlpp::BFGS<> opt;
+
+        Counted plain, cached;
+
+        auto f = ::nlpp::wrap::cache(::nlpp::wrap::functionGradient(cached, ::nlpp::fd::gradient(cached)));
+
+        auto x = opt(::nlpp::wrap::functionGradient(plain, ::nlpp::fd::gradient(plain)), ::nlpp::Vec::Constant(numVariables, 2.0));
+        auto xc = opt(f, ::nlpp::Vec::Constant(numVariables, 2.0));
+
+        /// The cached values are exactly the ones of the functor, so the path is the same with fewer calls
+        EXPECT_EQ((x - xc).norm(), 0.0);
+        EXPECT_LT(*cached.calls, *plain.calls);
+        EXPECT_GT(f.counter().functionHits + f.counter().gradientHits, 0);
+
+        /// A hit writing on the storage of the cache itself is not copied over
+        ASSERT_NE(f.find(xc), nullptr);
+
+        ::nlpp::Vec& storage = const_cast<::nlpp::Vec&>(f.find(xc)->g), gx = f.gradient(xc);
+
+        f.gradient(xc, storage);
+        f.functionGradient(xc, storage);
+
+        EXPECT_EQ(storage, gx);
+    }
+}
+
+
+TEST_F(WrappersTest, LineSearchEvaluationTest)
+{
+    SCOPED_TRACE("Line Search Evaluation Test");
+
+    ::nlpp::Rosenbrock func;
+
+    int funcCalls = 0, gradCalls = 0;
+
+    auto f = ::nlpp::wrap::functionGradient([&](const ::nlpp::Vec& x){ funcCalls++; return func(x); },
+                                            [&](const ::nlpp::Vec& x){ gradCalls++; return ::nlpp::ad::reverse(func)(x); });
+
+    for(int numVariables = 10; numVariables <= 50; numVariables += 20)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        ::nlpp::Vec x = ::nlpp::Vec::Constant(numVariables, 2.0), gx, dir;
+
+        f(x, gx);
+
+        dir = -gx / gx.norm();
+
+        ::nlpp::StrongWolfe<> lineSearch;
+
+        double fx;
+
+        funcCalls = gradCalls = 0;
+
+        auto a = lineSearch(f, x, dir, fx, gx);
+
+        /// With an exact gradient, every trial step is a single fused call, and the last one is reused.
+        /// The only function value alone is the one at the upper bound of the step
+        EXPECT_EQ(funcCalls, gradCalls + 1);
+
+        /// Either reused from the line search or evaluated again, the values are the ones at the accepted step
+        ::nlpp::Vec xn = x + a * dir, gn;
+
+        EXPECT_EQ(fx, f(xn, gn));
+        EXPECT_LT((gx - gn).norm(), 1e-12 * gn.norm());
+    }
+}
+
+
+} // namespace
@@ -1,10 +1,18 @@
 #include "gtest/gtest.h"
+#include <numeric>
 
 #include "GradientDescent/GradientDescent.h"
+#include "LineSearch/Backtracking/Backtracking.h"
 #include "CG/CG.h"
+#include "CG/CGDescent.h"
 #include "Newton/Newton.h"
+#include "Newton/TruncatedNewton.h"
 #include "QuasiNewton/BFGS/BFGS.h"
 #include "QuasiNewton/LBFGS/LBFGS.h"
+#include "QuasiNewton/OWLQN/OWLQN.h"
+#include "QuasiNewton/LBFGSB/LBFGSB.h"
+#include "Helpers/AutoDiff.h"
+#include "Helpers/SparseFiniteDifference.h"
 
 #include "TestFunctions/Rosenbrock.h"
 
@@ -59,6 +67,50 @@ TEST_F(LineSearchOptimizerTest, CGTest)
 }
 
 
+TEST_F(LineSearchOptimizerTest, CGDescentTest)
+{
+    SCOPED_TRACE("CG_DESCENT Test");
+
+    ::nlpp::CGDescent<> opt;
+
+    opt.stop = ::nlpp::stop::GradientOptimizer<>(10000, 1e-4, 1e-4, 1e-4);
+    
+    ::nlpp::Rosenbrock func;
+
+    for(int numVariables = 10; numVariables <= 100; numVariables += 10)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        convergenceTest(opt, func, ::nlpp::Vec::Constant(numVariables, -5.0));
+    }
+}
+
+
+TEST_F(LineSearchOptimizerTest, CGDescentFailedLineSearchTest)
+{
+    SCOPED_TRACE("CG_DESCENT Failed Line Search Test");
+
+    auto f = ::nlpp::wrap::functionGradient([](const ::nlpp::Vec& x){ return x.squaredNorm(); },
+                                            [](const ::nlpp::Vec& x) -> ::nlpp::Vec { return 2.0 * x; });
+
+    /// A single trial step, far past the minimum, with no iteration left to recover
+    ::nlpp::hz::ApproximateWolfe<> lineSearch(0.1, 0.9, 1e-6, 0.5, 0.66, 5.0, 0);
+
+    lineSearch.initialize();
+    lineSearch.psi0 = 1e3;
+
+    ::nlpp::Vec x = ::nlpp::Vec::Constant(5, 1.0), gx = 2.0 * x, dir = -gx, xn(5), gn(5);
+
+    double fx = x.squaredNorm();
+
+    /// No step is a decrease, so the line search stays at x
+    EXPECT_EQ(lineSearch(f, x, dir, fx, gx, xn, gn), 0.0);
+    EXPECT_EQ(fx, x.squaredNorm());
+    EXPECT_EQ(xn, x);
+    EXPECT_EQ(gn, gx);
+}
+
+
 TEST_F(LineSearchOptimizerTest, GradientDescentTest)
 {
     SCOPED_TRACE("Gradient Descent Test");
@@ -79,6 +131,44 @@ TEST_F(LineSearchOptimizerTest, GradientDescentTest)
     }
 }
 
+TEST_F(LineSearchOptimizerTest, BacktrackingBatchTest)
+{
+    SCOPED_TRACE("Backtracking Batch Test");
+
+    /// Only evaluates blocks of points, one per column
+    struct Batch
+    {
+        ::nlpp::Vec operator () (const ::nlpp::Mat& X)
+        {
+            ++*calls;
+            *points += X.cols();
+
+            return X.colwise().squaredNorm().transpose() + X.array().sin().colwise().sum().matrix().transpose();
+        }
+
+        std::shared_ptr<int> calls = std::make_shared<int>(0);
+        std::shared_ptr<int> points = std::make_shared<int>(0);
+    };
+
+    auto grad = [](const ::nlpp::Vec& x) -> ::nlpp::Vec { return 2.0 * x + x.array().cos().matrix(); };
+
+    for(int numVariables = 10; numVariables <= 50; numVariables += 20)
+    {
+        SCOPED_TRACE((std::string("N: ") + std::to_string(numVariables)).c_str());
+
+        ::nlpp::GradientDescent<::nlpp::Backtracking<>, ::nlpp::stop::GradientOptimizer<>, ::nlpp::out::GradientOptimizer<0>> opt;
+
+        Batch batch;
+
+        ::nlpp::Vec x = opt(::nlpp::wrap::functionGradient(batch, grad), ::nlpp::Vec(::nlpp::Vec::Constant(numVariables, 3.0)));
+
+        EXPECT_LT(grad(x).norm(), 1e-2);
+
+        /// Some of the trial steps were probed together
+        EXPECT_GT(*batch.points, *batch.calls);
+    }
+}
+
 TEST_F(LineSearchOptimizerTest, NewtonTest)
 {
     SCOPED_TRACE("Newton Test");
@@ -97,6 +187,187 @@ TEST_F(LineSearchOptimizerTest, NewtonTest)
     }
 }
 
+TEST_F(LineSearchOptimizerTest, CholeskyFactorizationTest)
+{
+    SCOPED_TRACE("Modified Cholesky Test");
+
+    int n = 30;
+
+    ::nlpp::Mat M = ::nlpp::Mat::Random(n, n), indefinite = M + M.transpose(), definite = M.transpose() * M + ::nlpp::Mat::Identity(n, n);
+
+    for(const ::nlpp::Mat& hess : {indefinite, definite})
+    {
+        ::nlpp::fact::CholeskyFactorization<> chol;
+
+        ::nlpp::Vec g = ::nlpp::Vec::Random(n), p = chol(g, hess);
+
+        ::nlpp::Mat L = chol.ldl.triangularView<Eigen::UnitLower>(), P = chol.transpositions * ::nlpp::Mat::Identity(n, n);
+        ::nlpp::Mat E = P.transpose() * L * chol.ldl.diagonal().asDiagonal() * L.transpose() * P - hess;
+
+        /// A nonnegative diagonal modification, and the direction solves the modified system
+        EXPECT_LT((E - ::nlpp::Mat(E.diagonal().asDiagonal())).norm(), 1e-10 * hess.norm());
+        EXPECT_GT(E.diagonal().minCoeff(), -1e-10 * hess.norm());
+        EXPECT_LT(((hess + ::nlpp::Mat(E.diagonal().asDiagonal())) * p + g).norm(), 1e-10 * g.norm());
+    }
+
+    /// No modification at all if the matrix is already positive definite
+    ::nlpp::fact::CholeskyFactorization<> chol;
+
+    ::nlpp::Vec g = ::nlpp::Vec::Random(n);
+
+    EXPECT_LT((chol(g, definite) + definite.llt().solve(g)).norm(), 1e-10 * g.norm());
+
+    ::nlpp::poly::Newton<::nlpp::fact::CholeskyFactorization<>> opt;
+
+    opt.stop = std::make_unique<::nlpp::stop::poly::GradientOptimizer<>>(1000, 1e-4, 1e-4, 1e-4);
+
+    convergenceTest(opt, ::nlpp::Rosenbrock{}, ::nlpp::Vec::Constant(50, 5.0));
+}
+
+TEST_F(LineSearchOptimizerTest, NewtonRefreshTest)
+{
+    SCOPED_TRACE("Newton Refresh Test");
+
+    auto grad = ::nlpp::ad::reverse(::nlpp::Rosenbrock{});
+    auto fdHess = ::nlpp::fd::hessian(::nlpp::wrap::functionGradient(::nlpp::Rosenbrock{}, grad));
+
+    int calls = 0;
+
+    auto hess = [&](const ::nlpp::Vec& x) -> ::nlpp::Mat { ++calls; return fdHess(x); };
+
+    using Newton = ::nlpp::Newton<::nlpp::fact::CholeskyFactorization<>, ::nlpp::StrongWolfe<>, ::nlpp::stop::GradientOptimizer<>, ::nlpp::out::GradientOptimizer<0>>;
+    using Shamanskii = ::nlpp::Newton<::nlpp::fact::CholeskyFactorization<>, ::nlpp::StrongWolfe<>, ::nlpp::stop::GradientOptimizer<>, ::nlpp::out::GradientOptimizer<0>, ::nlpp::newton::Shamanskii<>>;
+
+    for(int numVariables = 10; numVariables <= 50; numVariables += 20)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        Newton newton;
+        Shamanskii shamanskii;
+
+        newton.stop = shamanskii.stop = ::nlpp::stop::GradientOptimizer<>(1000, 0.0, 0.0, 1e-8);
+
+        calls = 0;
+        ::nlpp::Vec x = newton(::nlpp::Rosenbrock{}, grad, hess, ::nlpp::Vec::Constant(numVariables, 1.5));
+        int newtonCalls = calls;
+
+        calls = 0;
+        ::nlpp::Vec y = shamanskii(::nlpp::Rosenbrock{}, grad, hess, ::nlpp::Vec::Constant(numVariables, 1.5));
+
+        EXPECT_LT(grad(x).norm(), 1e-8);
+        EXPECT_LT(grad(y).norm(), 1e-8);
+        EXPECT_LT(calls, newtonCalls);
+    }
+}
+
+TEST_F(LineSearchOptimizerTest, SparseNewtonTest)
+{
+    SCOPED_TRACE("Sparse Newton Test");
+
+    ::nlpp::Rosenbrock func;
+
+    auto grad = ::nlpp::ad::reverse(func);
+
+    using Sparse = ::nlpp::Newton<::nlpp::fact::SparseCholeskyIdentity<>, ::nlpp::StrongWolfe<>, ::nlpp::stop::GradientOptimizer<>, ::nlpp::out::GradientOptimizer<0>>;
+    using Dense = ::nlpp::Newton<::nlpp::fact::CholeskyIdentity<>, ::nlpp::StrongWolfe<>, ::nlpp::stop::GradientOptimizer<>, ::nlpp::out::GradientOptimizer<0>>;
+
+    for(int numVariables = 10; numVariables <= 100; numVariables += 30)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        ::nlpp::Vec x0 = ::nlpp::Vec::Constant(numVariables, 2.0);
+
+        auto sparseHess = ::nlpp::fd::sparseGradientHessian(grad, ::nlpp::fd::hessianPattern(func, x0));
+        auto denseHess = [&](const ::nlpp::Vec& x) -> ::nlpp::Mat { return sparseHess(x); };
+
+        Sparse sparse;
+        Dense dense;
+
+        sparse.stop = dense.stop = ::nlpp::stop::GradientOptimizer<>(1000, 0.0, 0.0, 1e-8);
+
+        ::nlpp::Vec x = sparse(func, grad, sparseHess, x0);
+        ::nlpp::Vec y = dense(func, grad, denseHess, x0);
+
+        /// Same shifts and the same hessians, only the factorization changes
+        EXPECT_LT(grad(x).norm(), 1e-8);
+        EXPECT_LT((x - y).norm(), 1e-8);
+    }
+}
+
+TEST_F(LineSearchOptimizerTest, SparseSolverPatternTest)
+{
+    SCOPED_TRACE("Sparse Solver Pattern Test");
+
+    using Sparse = Eigen::SparseMatrix<double>;
+
+    /// Same size and number of nonzeros, with the off diagonal pair at (i, j)
+    auto matrix = [](int i, int j)
+    {
+        std::vector<Eigen::Triplet<double>> triplets = {{0, 0, 4.0}, {1, 1, 4.0}, {2, 2, 4.0}, {i, j, 1.0}, {j, i, 1.0}};
+
+        Sparse m(3, 3);
+        m.setFromTriplets(triplets.begin(), triplets.end());
+
+        return m;
+    };
+
+    ::nlpp::impl::SymmetricSolver<Sparse> solver;
+
+    ::nlpp::Vec b = ::nlpp::Vec::LinSpaced(3, 1.0, 3.0);
+
+    for(auto ij : {std::make_pair(0, 1), std::make_pair(0, 2), std::make_pair(1, 2), std::make_pair(1, 2)})
+    {
+        Sparse m = matrix(ij.first, ij.second);
+
+        solver.compute(m);
+
+        EXPECT_LT((m * solver.solve(b) - b).norm(), 1e-12);
+    }
+}
+
+
+TEST_F(LineSearchOptimizerTest, TruncatedNewtonTest)
+{
+    SCOPED_TRACE("Truncated Newton Test");
+
+    ::nlpp::poly::TruncatedNewton<> opt;
+
+    opt.stop = std::make_unique<::nlpp::stop::poly::GradientOptimizer<>>(1000, 1e-4, 1e-4, 1e-4);
+    
+    ::nlpp::Rosenbrock func;
+
+    for(int numVariables = 10; numVariables <= 100; numVariables += 10)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        convergenceTest(opt, func, ::nlpp::Vec::Constant(numVariables, 5.0));
+    }
+
+    /// Only hessian vector products given by the user
+    auto grad = ::nlpp::ad::reverse(func);
+
+    /// Central difference of the gradient along e, so the hessian is never formed
+    int products = 0;
+
+    auto hv = [&](const ::nlpp::Vec& x, const ::nlpp::Vec& e) -> ::nlpp::Vec
+    {
+        double h = std::cbrt(::nlpp::constants::eps) * std::max(1.0, x.norm()) / e.norm();
+
+        products++;
+
+        return (grad(::nlpp::Vec(x + h * e)) - grad(::nlpp::Vec(x - h * e))) / (2 * h);
+    };
+
+    ::nlpp::TruncatedNewton<::nlpp::StrongWolfe<>, ::nlpp::stop::GradientOptimizer<>, ::nlpp::out::GradientOptimizer<0>> tn;
+
+    tn.stop = ::nlpp::stop::GradientOptimizer<>(1000, 0.0, 0.0, 1e-8);
+
+    ::nlpp::Vec x = tn(func, grad, hv, ::nlpp::Vec::Constant(30, 1.5));
+
+    EXPECT_LT(grad(x).norm(), 1e-8);
+    EXPECT_GT(products, 0);
+}
+
 TEST_F(LineSearchOptimizerTest, BFGSTest)
 {
     SCOPED_TRACE("BFGS Test\n");
@@ -115,6 +386,69 @@ TEST_F(LineSearchOptimizerTest, BFGSTest)
     }
 }
 
+TEST_F(LineSearchOptimizerTest, BFGSUpdateTest)
+{
+    SCOPED_TRACE("BFGS Update Test");
+
+    int n = 20;
+
+    ::nlpp::Mat M = ::nlpp::Mat::Random(n, n), hess = M.transpose() * M + ::nlpp::Mat::Identity(n, n), In = ::nlpp::Mat::Identity(n, n);
+    ::nlpp::Vec s = ::nlpp::Vec::Random(n), y = hess.llt().solve(s), hy(n);
+
+    double rho = 1.0 / y.dot(s);
+
+    ::nlpp::Mat product = (In - rho * s * y.transpose()) * hess * (In - rho * y * s.transpose()) + rho * s * s.transpose();
+
+    ::nlpp::bfgs::Inverse<>::update(hess, s, y, hy);
+
+    /// Only the lower triangle is updated
+    EXPECT_LT((::nlpp::Mat(hess.triangularView<Eigen::Lower>()) - ::nlpp::Mat(product.triangularView<Eigen::Lower>())).norm(), 1e-10 * product.norm());
+}
+
+TEST_F(LineSearchOptimizerTest, BFGSCholeskyTest)
+{
+    SCOPED_TRACE("BFGS Cholesky Test");
+
+    int n = 30;
+
+    ::nlpp::Mat M = ::nlpp::Mat::Random(n, n), A = M.transpose() * M + ::nlpp::Mat::Identity(n, n);
+
+    ::nlpp::bfgs::Inverse<> inverse;
+    ::nlpp::bfgs::Cholesky<> cholesky;
+
+    inverse.init(::nlpp::Mat::Identity(n, n));
+    cholesky.init(::nlpp::Mat::Identity(n, n));
+
+    for(int k = 0; k < 10; ++k)
+    {
+        ::nlpp::Vec s = ::nlpp::Vec::Random(n), y = A * s, g = ::nlpp::Vec::Random(n), d1(n), d2(n);
+
+        inverse.update(s, y);
+        cholesky.update(s, y);
+
+        inverse.direction(g, d1);
+        cholesky.direction(g, d2);
+
+        /// The factor is of the inverse of the inverse hessian
+        EXPECT_LT((d1 - d2).norm(), 1e-8 * d1.norm());
+    }
+
+    /// An indefinite initial inverse hessian falls back to a scaled identity
+    ::nlpp::Vec g = ::nlpp::Vec::Random(n), d(n);
+
+    cholesky.init(-2.0 * ::nlpp::Mat::Identity(n, n));
+    cholesky.direction(g, d);
+
+    EXPECT_EQ(cholesky.llt.info(), Eigen::Success);
+    EXPECT_LT((d + 2.0 * g).norm(), 1e-12 * g.norm());
+
+    ::nlpp::poly::BFGS<::nlpp::BFGS_Constant<>, ::nlpp::Vec, ::nlpp::bfgs::Cholesky<>> opt;
+
+    opt.stop = std::make_unique<::nlpp::stop::poly::GradientOptimizer<>>(10000, 1e-4, 1e-4, 1e-4);
+
+    convergenceTest(opt, ::nlpp::Rosenbrock{}, ::nlpp::Vec::Constant(50, 2.0));
+}
+
 TEST_F(LineSearchOptimizerTest, LBFGSTest)
 {
     SCOPED_TRACE("LBFGS Test");
@@ -133,5 +467,230 @@ TEST_F(LineSearchOptimizerTest, LBFGSTest)
     }
 }
 
+TEST_F(LineSearchOptimizerTest, LBFGSDiagonalScalingTest)
+{
+    SCOPED_TRACE("LBFGS Diagonal Scaling Test");
+
+    ::nlpp::poly::LBFGS<::nlpp::LBFGS_DiagonalScaling<>> opt;
+
+    opt.stop = std::make_unique<::nlpp::stop::poly::GradientOptimizer<>>(10000, 1e-4, 1e-4, 1e-4);
+    
+    ::nlpp::Rosenbrock func;
+
+    for(int numVariables = 10; numVariables <= 100; numVariables += 10)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        convergenceTest(opt, func, ::nlpp::Vec::Constant(numVariables, 2.0));
+    }
+
+    /// Tiny pairs near a solution still have positive curvature, so they update both scalings
+    ::nlpp::Vec s = ::nlpp::Vec::Constant(10, 1e-6), y = 4.0 * s;
+
+    ::nlpp::LBFGS_Scaling<> scaling;
+    ::nlpp::LBFGS_DiagonalScaling<> diagonal;
+
+    scaling.init(y);
+    diagonal.init(y);
+
+    scaling.update(s, y);
+    diagonal.update(s, y);
+
+    EXPECT_DOUBLE_EQ(scaling.gamma, 0.25);
+    EXPECT_LT((diagonal.d.array() - 0.25).abs().maxCoeff(), 1e-12);
+
+    /// A pair of negative curvature changes nothing
+    scaling.update(s, -y);
+    diagonal.update(s, -y);
+
+    EXPECT_DOUBLE_EQ(scaling.gamma, 0.25);
+    EXPECT_LT((diagonal.d.array() - 0.25).abs().maxCoeff(), 1e-12);
+}
+
+TEST_F(LineSearchOptimizerTest, LBFGSHistoryTest)
+{
+    SCOPED_TRACE("LBFGS History Test");
+
+    using Ring = ::nlpp::poly::LBFGS<::nlpp::BFGS_Constant<>, ::nlpp::Vec, ::nlpp::lbfgs::Ring<>>;
+    using Deque = ::nlpp::poly::LBFGS<::nlpp::BFGS_Constant<>, ::nlpp::Vec, ::nlpp::lbfgs::Deque<>>;
+
+    ::nlpp::Rosenbrock func;
+
+    for(int numVariables = 10; numVariables <= 50; numVariables += 20)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        Ring ring;
+        Deque deque;
+
+        ring.stop = std::make_unique<::nlpp::stop::poly::GradientOptimizer<>>(100, 0.0, 0.0, 0.0);
+        deque.stop = std::make_unique<::nlpp::stop::poly::GradientOptimizer<>>(100, 0.0, 0.0, 0.0);
+        ring.m = deque.m = 5;
+
+        /// Same pairs and the same recursion, only the storage changes
+        ::nlpp::Vec x = ring(func, ::nlpp::Vec::Constant(numVariables, 2.0));
+        ::nlpp::Vec y = deque(func, ::nlpp::Vec::Constant(numVariables, 2.0));
+
+        EXPECT_LT((x - y).norm(), 1e-8 * x.norm());
+    }
+}
+
+
+TEST_F(LineSearchOptimizerTest, LBFGSMixedPrecisionTest)
+{
+    SCOPED_TRACE("LBFGS Mixed Precision Test");
+
+    ::nlpp::Rosenbrock func;
+
+    for(int numVariables = 10; numVariables <= 100; numVariables += 30)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        /// Pairs stored in single precision, the recursion still in double
+        ::nlpp::poly::LBFGS<::nlpp::LBFGS_Scaling<>, ::nlpp::Vec, ::nlpp::lbfgs::Ring<double, float>> opt;
+
+        opt.stop = std::make_unique<::nlpp::stop::poly::GradientOptimizer<>>(10000, 1e-4, 1e-4, 1e-4);
+
+        convergenceTest(opt, func, ::nlpp::Vec::Constant(numVariables, 2.0));
+    }
+}
+
+
+TEST_F(LineSearchOptimizerTest, LBFGSCompactTest)
+{
+    SCOPED_TRACE("LBFGS Compact Representation Test");
+
+    int n = 30, m = 5;
+
+    ::nlpp::Mat M = ::nlpp::Mat::Random(n, n), A = M.transpose() * M + ::nlpp::Mat::Identity(n, n);
+
+    ::nlpp::lbfgs::Ring<> ring;
+    ::nlpp::lbfgs::Compact<> compact, parallel(4);
+
+    ring.init(n, m);
+    compact.init(n, m);
+    parallel.init(n, m);
+
+    /// More pairs than the memory, so the buffers wrap around
+    for(int k = 0; k < 8; ++k)
+    {
+        ::nlpp::Vec s = ::nlpp::Vec::Random(n), y = A * s, g = ::nlpp::Vec::Random(n);
+
+        ring.update(s, y);
+        compact.update(s, y);
+        parallel.update(s, y);
+
+        double gamma = s.dot(y) / y.dot(y);
+
+        ::nlpp::Vec d1(n), d2(n), d3(n), Bd(n);
+
+        ring.direction(g, gamma, d1);
+        compact.direction(g, gamma, d2);
+        parallel.direction(g, gamma, d3);
+
+        EXPECT_LT((d1 - d2).norm(), 1e-10 * d1.norm());
+        EXPECT_LT((d2 - d3).norm(), 1e-10 * d2.norm());
+
+        /// The recursion restricted to every row is the full one
+        std::vector<int> rows(n);
+        std::iota(rows.begin(), rows.end(), 0);
+
+        ::nlpp::Vec d4(n);
+
+        ring.direction(g, gamma, d4, rows);
+
+        EXPECT_LT((d1 - d4).norm(), 1e-10 * d1.norm());
+
+        /// The hessian is the inverse of the inverse hessian
+        compact.product(d2, gamma, Bd);
+
+        EXPECT_LT((Bd + g).norm(), 1e-8 * g.norm());
+    }
+}
+
+
+TEST_F(LineSearchOptimizerTest, OWLQNTest)
+{
+    SCOPED_TRACE("OWLQN Test");
+
+    int rows = 100, cols = 50;
+
+    ::nlpp::Mat A = ::nlpp::Mat::Random(rows, cols);
+    ::nlpp::Vec xs = ::nlpp::Vec::Zero(cols);
+
+    for(int i = 0; i < cols; i += 10)
+        xs(i) = 1.0 + i;
+
+    ::nlpp::Vec b = A * xs + 0.1 * ::nlpp::Vec::Random(rows);
+
+    /// Lasso: 0.5 * ||Ax - b||^2 + l1 * ||x||_1
+    auto f = ::nlpp::wrap::functionGradient([&](const ::nlpp::Vec& x, ::nlpp::Vec& g)
+    {
+        ::nlpp::Vec r = A * x - b;
+
+        g = A.transpose() * r;
+
+        return 0.5 * r.squaredNorm();
+    });
+
+    ::nlpp::OWLQN<> opt;
+
+    opt.l1 = 10.0;
+    opt.stop.maxIterations_ = 1000;
+    opt.stop.xTol = opt.stop.fTol = 0.0;
+    opt.stop.gTol = 1e-8;
+
+    ::nlpp::Vec x = opt(f, ::nlpp::Vec::Zero(cols)), gx(cols), pg(cols);
+
+    f(x, gx);
+
+    decltype(opt)::pseudoGradient(x, gx, opt.l1, pg);
+
+    /// Optimality: a null subgradient, with exact zeros for the unused variables
+    EXPECT_LT(pg.norm(), 1e-6);
+    EXPECT_GT((x.array() == 0.0).count(), cols / 2);
+    EXPECT_TRUE(((x.array() == 0.0) || (gx.array().abs() - opt.l1).abs() < 1e-6).all());
+
+    /// The support of the true solution is recovered exactly
+    for(int i = 0; i < cols; i += 10)
+        EXPECT_GT(x(i), 0.0) << "i = " << i;
+
+    EXPECT_EQ((x.array() != 0.0).count(), cols / 10);
+}
+
+
+TEST_F(LineSearchOptimizerTest, LBFGSBTest)
+{
+    SCOPED_TRACE("LBFGSB Test");
+
+    ::nlpp::Rosenbrock func;
+
+    for(int numVariables = 10; numVariables <= 100; numVariables += 30)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        /// Every third variable is bounded away from the unconstrained minimizer
+        ::nlpp::Vec l = ::nlpp::Vec::Constant(numVariables, -2.0), u = ::nlpp::Vec::Constant(numVariables, 2.0);
+
+        for(int i = 0; i < numVariables; i += 3)
+            u(i) = 0.5;
+
+        ::nlpp::LBFGSB<> opt(l, u);
+
+        opt.stop.maxIterations_ = 10000;
+        opt.stop.xTol = opt.stop.fTol = 0.0;
+        opt.stop.gTol = 1e-6;
+
+        ::nlpp::Vec x = opt(func, ::nlpp::Vec::Constant(numVariables, -1.5));
+        ::nlpp::Vec gx = ::nlpp::fd::gradient(func)(x), pg;
+
+        decltype(opt)::projectedGradient(x, gx, l, u, pg);
+
+        EXPECT_LT(pg.norm(), 1e-4);
+        EXPECT_TRUE((x.array() >= l.array()).all() && (x.array() <= u.array()).all());
+        EXPECT_EQ(x(0), 0.5);
+    }
+}
+
 
 } // namespace
\ No newline at end of file
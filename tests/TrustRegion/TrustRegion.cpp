@@ -4,7 +4,9 @@
 #include "TrustRegion/DogLeg/DogLeg.h"
 #include "TrustRegion/IndefiniteDogLeg/IndefiniteDogLeg.h"
 #include "TrustRegion/IterativeTR/IterativeTR.h"
+#include "TrustRegion/Steihaug/Steihaug.h"
 
+#include "Helpers/SparseFiniteDifference.h"
 #include "TestFunctions/Rosenbrock.h"
 
 
@@ -73,6 +75,67 @@ TEST_F(TrustRegionTest, DogLeg)
     }
 }
 
+TEST_F(TrustRegionTest, SparseDogLeg)
+{
+    SCOPED_TRACE("Sparse Dog Leg Test");
+
+    ::nlpp::SparseDogLeg<::nlpp::stop::GradientNorm<>> opt;
+    opt.stop = ::nlpp::stop::GradientNorm<>(10000, 1e-4);
+    
+    ::nlpp::Rosenbrock func;
+
+    auto grad = ::nlpp::fd::gradient(func);
+
+    for(int numVariables = 10; numVariables <= 100; numVariables += 30)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        ::nlpp::Vec x0 = ::nlpp::Vec::Constant(numVariables, 2.0);
+
+        /// Tridiagonal, found by finite differences at the initial point
+        auto hess = ::nlpp::fd::sparseHessian(func, ::nlpp::fd::hessianPattern(func, x0));
+
+        ::nlpp::Vec x = opt(func, grad, hess, x0);
+
+        EXPECT_TRUE(opt.stop(opt, x, func(x), grad(x)));
+    }
+}
+
+TEST_F(TrustRegionTest, Steihaug)
+{
+    SCOPED_TRACE("Steihaug Test");
+
+    ::nlpp::Steihaug<::nlpp::stop::GradientNorm<>> opt;
+    opt.stop = ::nlpp::stop::GradientNorm<>(10000, 1e-4);
+    
+    ::nlpp::Rosenbrock func;
+
+    for(int numVariables = 10; numVariables <= 100; numVariables += 10)
+    {
+        SCOPED_TRACE((std::string("Rosenbrock \t N: ") + std::to_string(numVariables)).c_str());
+
+        convergenceTest(opt, func, ::nlpp::Vec::Constant(numVariables, 2.0));
+    }
+}
+
+TEST_F(TrustRegionTest, PolySteihaug)
+{
+    SCOPED_TRACE("Poly Steihaug Test");
+
+    ::nlpp::poly::Steihaug<> opt;
+    opt.stop = std::make_unique<::nlpp::stop::poly::GradientOptimizer<>>(10000, 0.0, 0.0, 1e-4);
+
+    ::nlpp::Rosenbrock func;
+    ::nlpp::wrap::poly::FunctionGradient<> f(func);
+
+    /// A copy clones the local minimizer
+    auto copy = opt;
+
+    ::nlpp::Vec x = copy.optimize(f, ::nlpp::Vec::Constant(20, 2.0));
+
+    EXPECT_LT(::nlpp::fd::gradient(func)(x).norm(), 1e-4);
+}
+
 TEST_F(TrustRegionTest, IndefiniteDogLeg)
 {
     SCOPED_TRACE("Indefinite Dog Leg Test");